@@ -0,0 +1,336 @@
+/*
+  student_bench.c
+  Student Record & Result Management System - benchmark suite for the
+  core library (libstudentcore.a)
+
+  Generates rosters of increasing size in memory (core_generate) and times
+  the paths both front ends lean on: CSV load and save, id lookups,
+  enrollment lookups, SGPA and CGPA, sorted listings, the CSV export,
+  report cards, index builds and dataset copies. Each case first runs
+  untimed warm-up rounds (caches, page cache, allocator), then a number of
+  timed rounds, each repeating the case until it has run for at least
+  ROUND_MIN_NS so that quick cases are not timed at the clock's grain; the
+  fastest round gives ns/op and ops/s. Rounds are spread over the whole
+  run, one pass over every size and case per round, so a slow spell of
+  the machine costs a case a round or two rather than all of them. Noise only ever
+  makes a round slower, so the minimum is the steadiest estimate, and one
+  slow round (a page fault storm, a noisy neighbour) does not move it.
+  Peak RSS is sampled after every case.
+
+  Results print as a table, or as JSON with -o (one result per line, so
+  the baseline reader below needs no JSON parser). With -b the run is
+  compared against such a file: any case slower than the baseline by more
+  than the threshold is flagged, and the exit status is 1. Generating the
+  roster is timed once per size, for information; a single shot is too
+  noisy to gate on, so it is left out of the comparison.
+
+  usage: student_bench [-n sizes] [-r rounds] [-w warmup] [-s seed] [-o out.json] [-b baseline.json] [-t pct]
+         sizes is a comma list (default 256,1024,2048; at most MAX_STUDENTS)
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/resource.h>
+
+#include "student_core.h"
+
+#define MAX_SIZES 16
+#define MAX_ROUNDS 1000
+#define MAX_RESULTS 256
+#define ROUND_MIN_NS 2000000LL      /* 2 ms */
+
+typedef struct {
+    char name[32];
+    int students;
+    long long ops;                  /* per run of the case */
+    double ns_per_op;               /* fastest round */
+    double ops_per_sec;
+    long rss_kb;                    /* peak RSS so far */
+    int single;                     /* timed once: reported, not compared */
+} Result;
+
+static CoreDb db, copy;
+static CoreIndex ix;
+static int *order;                  /* room for MAX_STUDENTS slots */
+static volatile double sink;        /* keeps results alive under -O2 */
+static Result results[MAX_RESULTS];
+static int nresults;
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage ru;
+    return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : 0;
+}
+
+/* ---------- Cases ----------
+   Each runs one round over db and returns the operations it did. */
+static long long case_index_build(void) {
+    core_index_build(&ix, &db);
+    return 1;
+}
+
+static long long case_student_slot(void) {
+    long long found = 0;
+    for (int i = 0; i < db.count; ++i) found += core_student_slot(&ix, &db, db.students[i].id) >= 0;
+    if (found != db.count) fprintf(stderr, "lookup mismatch\n");
+    return db.count;
+}
+
+/* the marks/attendance row of each enrollment, looked up by subject */
+static long long case_enrollment(void) {
+    long long ops = 0;
+    for (int i = 0; i < db.count; ++i) {
+        const Enrollment *e = db.enrollments + db.students[i].first;
+        for (int k = 0; k < db.students[i].num_subjects; ++k, ++ops) sink += core_enrollment(&db, i, e[k].subject)->held;
+    }
+    return ops;
+}
+
+static long long case_sgpa(void) {
+    long long ops = 0;
+    for (int i = 0; i < db.count; ++i)
+        for (int sem = 1; sem <= db.students[i].current_semester; ++sem, ++ops) sink += core_gpa(&db, i, sem, NULL);
+    return ops;
+}
+
+static long long case_cgpa(void) {
+    for (int i = 0; i < db.count; ++i) sink += core_gpa(&db, i, 0, NULL);
+    return db.count;
+}
+
+static long long case_sort_id(void) {
+    sink += core_sorted_slots(&db, CORE_BY_ID, order);
+    return 1;
+}
+
+static long long case_sort_name(void) {
+    sink += core_sorted_slots(&db, CORE_BY_NAME, order);
+    return 1;
+}
+
+static long long case_copy(void) {
+    core_copy(&copy, &db);
+    sink += copy.count;
+    return 1;
+}
+
+/* file cases run in the scratch directory */
+static long long case_save(void) {
+    core_save(&db, NULL);
+    return 1;
+}
+
+static long long case_load(void) {
+    core_load(&copy, NULL, NULL);
+    if (copy.count != db.count || copy.enroll_count != db.enroll_count) fprintf(stderr, "round trip mismatch\n");
+    return 1;
+}
+
+static long long case_export(void) {
+    FILE *f = fopen("export.csv", "w");
+    if (!f) return 0;
+    core_export_csv(&db, f);
+    fclose(f);
+    return 1;
+}
+
+static long long case_report_card(void) {
+    FILE *f = fopen("report.txt", "w");
+    if (!f) return 0;
+    for (int i = 0; i < db.count; ++i) core_report_card(&db, i, "End-Sem", (time_t)0, f);
+    fclose(f);
+    return db.count;
+}
+
+typedef struct {
+    const char *name;
+    long long (*run)(void);
+} Case;
+
+static const Case CASES[] = {
+    { "index_build",   case_index_build },
+    { "student_slot",  case_student_slot },
+    { "enrollment",    case_enrollment },
+    { "sgpa",          case_sgpa },
+    { "cgpa",          case_cgpa },
+    { "sort_id",       case_sort_id },
+    { "sort_name",     case_sort_name },
+    { "copy",          case_copy },
+    { "save",          case_save },
+    { "load",          case_load },
+    { "export",        case_export },
+    { "report_card",   case_report_card },
+};
+#define NCASES ((int)(sizeof(CASES) / sizeof(CASES[0])))
+
+static Result *add_result(const char *name, int students, long long ops, double ns_per_op) {
+    if (nresults == MAX_RESULTS) return NULL;
+    Result *r = &results[nresults++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->students = students;
+    r->ops = ops;
+    r->ns_per_op = ns_per_op;
+    r->ops_per_sec = ns_per_op > 0 ? 1e9 / ns_per_op : 0;
+    r->rss_kb = peak_rss_kb();
+    r->single = 0;
+    return r;
+}
+
+/* one timed round of c, repeated for at least ROUND_MIN_NS; ns per op,
+   with the ops of one run in *ops */
+static double time_round(const Case *c, long long *ops) {
+    long long t = now_ns(), elapsed, done = 0;
+    do {
+        *ops = c->run();
+        done += *ops;
+    } while ((elapsed = now_ns() - t) < ROUND_MIN_NS);
+    return (double)elapsed / (double)(done ? done : 1);
+}
+
+/* ---------- Output ---------- */
+static void print_table(void) {
+    printf("%-14s %8s %10s %14s %14s %10s\n", "case", "students", "ops/run", "ns/op", "ops/s", "rss KB");
+    for (int i = 0; i < nresults; ++i) {
+        const Result *r = &results[i];
+        printf("%-14s %8d %10lld %14.1f %14.0f %10ld\n", r->name, r->students, r->ops, r->ns_per_op,
+               r->ops_per_sec, r->rss_kb);
+    }
+}
+
+static int write_json(const char *path, unsigned long long seed, int warmup, int rounds) {
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    fprintf(f, "{\"seed\":%llu,\"warmup\":%d,\"rounds\":%d,\"max_students\":%d,\"peak_rss_kb\":%ld,\"results\":[\n",
+            seed, warmup, rounds, MAX_STUDENTS, peak_rss_kb());
+    for (int i = 0; i < nresults; ++i) {
+        const Result *r = &results[i];
+        fprintf(f, "{\"name\":\"%s\",\"students\":%d,\"ops\":%lld,\"ns_per_op\":%.3f,\"ops_per_sec\":%.1f,\"rss_kb\":%ld,"
+                   "\"single_shot\":%s}%s\n",
+                r->name, r->students, r->ops, r->ns_per_op, r->ops_per_sec, r->rss_kb, r->single ? "true" : "false",
+                i + 1 < nresults ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    if (f != stdout) fclose(f);
+    return 0;
+}
+
+/* compare against a file write_json made; the number of regressions, -1
+   if it cannot be read */
+static int compare_baseline(const char *path, double threshold) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[512];
+    int regressions = 0, matched = 0;
+    printf("\n%-14s %8s %14s %14s %9s\n", "case", "students", "baseline ns", "now ns", "change");
+    while (fgets(line, sizeof(line), f)) {
+        char name[32];
+        int students;
+        long long ops;
+        double base;
+        if (sscanf(line, "{\"name\":\"%31[^\"]\",\"students\":%d,\"ops\":%lld,\"ns_per_op\":%lf", name, &students, &ops,
+                   &base) != 4)
+            continue;
+        for (int i = 0; i < nresults; ++i) {
+            const Result *r = &results[i];
+            if (r->single || r->students != students || strcmp(r->name, name) != 0) continue;
+            double change = base > 0 ? (r->ns_per_op - base) / base * 100.0 : 0;
+            int slower = change > threshold;
+            regressions += slower;
+            matched++;
+            printf("%-14s %8d %14.1f %14.1f %+8.1f%%%s\n", name, students, base, r->ns_per_op, change,
+                   slower ? "  REGRESSION" : "");
+        }
+    }
+    fclose(f);
+    printf("%d cases compared, %d slower than baseline by more than %.0f%%\n", matched, regressions, threshold);
+    return regressions;
+}
+
+static int rm_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw) {
+    (void)st; (void)flag; (void)ftw;
+    return remove(path);
+}
+
+int main(int argc, char **argv) {
+    int sizes[MAX_SIZES] = { 256, 1024, MAX_STUDENTS }, nsizes = 3, rounds = 20, warmup = 2;
+    unsigned long long seed = 1;
+    const char *out = NULL, *baseline = NULL;
+    double threshold = 10.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:w:s:o:b:t:")) != -1) {
+        switch (opt) {
+        case 'n':
+            nsizes = 0;
+            for (char *p = optarg; *p && nsizes < MAX_SIZES; ) {
+                int v = atoi(p);
+                sizes[nsizes++] = v < 1 ? 1 : v > MAX_STUDENTS ? MAX_STUDENTS : v;
+                p += strcspn(p, ",");
+                if (*p) ++p;
+            }
+            break;
+        case 'r': rounds = atoi(optarg); break;
+        case 'w': warmup = atoi(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 0); break;
+        case 'o': out = optarg; break;
+        case 'b': baseline = optarg; break;
+        case 't': threshold = atof(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n sizes] [-r rounds] [-w warmup] [-s seed] [-o out.json] [-b baseline.json] [-t pct]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (nsizes == 0) { sizes[0] = MAX_STUDENTS; nsizes = 1; }
+    if (rounds < 1) rounds = 1;
+    if (rounds > MAX_ROUNDS) rounds = MAX_ROUNDS;
+    if (warmup < 0) warmup = 0;
+    order = malloc(sizeof(int) * MAX_STUDENTS);
+    if (!order) return 1;
+
+    /* file cases go through data/ in a scratch directory */
+    char dir[] = "/tmp/student-bench-XXXXXX", cwd[4096];
+    if (!mkdtemp(dir) || !getcwd(cwd, sizeof(cwd)) || chdir(dir) != 0) { perror("scratch dir"); return 1; }
+
+    static Result *best[MAX_SIZES][NCASES];
+    for (int pass = 0; pass < rounds; ++pass) {
+        for (int z = 0; z < nsizes; ++z) {
+            int n = sizes[z];
+            long long t = now_ns();
+            core_generate(&db, n, seed);
+            db.version = 1;
+            if (pass == 0) {
+                Result *gen = add_result("generate", n, 1, (double)(now_ns() - t));
+                if (gen) gen->single = 1;
+            }
+            core_index_build(&ix, &db);
+            for (int c = 0; c < NCASES; ++c) {
+                if (pass == 0) for (int w = 0; w < warmup; ++w) CASES[c].run();
+                long long ops;
+                double ns = time_round(&CASES[c], &ops);
+                Result *r = best[z][c];
+                if (!r) best[z][c] = add_result(CASES[c].name, n, ops, ns);
+                else if (ns < r->ns_per_op) {
+                    r->ns_per_op = ns;
+                    r->ops_per_sec = 1e9 / ns;
+                }
+            }
+        }
+    }
+
+    if (chdir(cwd) != 0) perror("chdir");
+    nftw(dir, rm_entry, 8, FTW_DEPTH | FTW_PHYS);
+
+    if (!out || strcmp(out, "-") != 0) print_table();
+    if (out && write_json(out, seed, warmup, rounds) < 0) return 1;
+    if (baseline && compare_baseline(baseline, threshold) != 0) return 1;
+    return 0;
+}
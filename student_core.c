@@ -0,0 +1,927 @@
+/*
+  student_core.c
+  Student Record & Result Management System - core data model, indexes,
+  results and CSV storage shared by the console and web front ends
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "student_core.h"
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+const char *const core_file_names[CORE_FILES] = {
+    "students.csv", "subjects.csv", "marks.csv", "attendance.csv", "accounts.csv"
+};
+
+/* ---------- Default syllabus (per-semester subject lists & credits) ---------- */
+static const SyllabusEntry SEM1[] = {
+    {"Programming in C",5}, {"Linux Lab",2}, {"Problem Solving",2},
+    {"Advanced Engineering Mathematics - I",4}, {"Physics for Computer Engineers",5},
+    {"Managing Self",2}, {"Environmental Sustainability and Climate Change",2}, {NULL,0}
+};
+
+static const SyllabusEntry SEM2[] = {
+    {"Data Structures and Algorithms",5}, {"Digital Electronics",3}, {"Python Programming",5},
+    {"Advanced Engineering Mathematics - II",4}, {"Environmental Sustainability and Climate Change",2},
+    {"Time and Priority Management",2}, {"Elements of AI/ML",3}, {NULL,0}
+};
+
+static const SyllabusEntry SEM3[] = {
+    {"Leading Conversations",2}, {"Discrete Mathematical Structures",3}, {"Operating Systems",3},
+    {"Elements of AI/ML",3}, {"Database Management Systems",5}, {"Design and Analysis of Algorithms",4}, {NULL,0}
+};
+
+static const SyllabusEntry SEM4[] = {
+    {"Software Engineering",3}, {"EDGE - Soft Skills",0}, {"Linear Algebra",3}, {"Indian Constitution",0},
+    {"Writing with Impact",2}, {"Object Oriented Programming",4}, {"Data Communication and Networks",4},
+    {"Applied Machine Learning",5}, {NULL,0}
+};
+
+static const SyllabusEntry SEM5[] = {
+    {"Cryptography and Network Security",3}, {"Formal Languages and Automata Theory",3},
+    {"Object Oriented Analysis and Design",3}, {"Exploratory-3",3}, {"Start your Startup",2},
+    {"Research Methodology in CS",3}, {"Probability, Entropy, and MC Simulation",3},
+    {"PE-2",4}, {"PE-2 Lab",1}, {NULL,0}
+};
+
+static const SyllabusEntry SEM6[] = {
+    {"Exploratory-4",3}, {"Leadership and Teamwork",2}, {"Compiler Design",3},
+    {"Statistics and Data Analysis",3}, {"PE-3",4}, {"PE-3 Lab",1}, {"Minor Project",5}, {NULL,0}
+};
+
+static const SyllabusEntry SEM7[] = {
+    {"Exploratory-5",3}, {"PE-4",4}, {"PE-4 Lab",1}, {"PE-5",3}, {"PE-5 Lab",1},
+    {"Capstone Project - Phase-1",5}, {"Summer Internship",1}, {NULL,0}
+};
+
+static const SyllabusEntry SEM8[] = {
+    {"IT Ethical Practices",3}, {"Capstone Project - Phase-2",5}, {NULL,0}
+};
+
+const SyllabusEntry *const core_syllabus[9] = {
+    NULL, SEM1, SEM2, SEM3, SEM4, SEM5, SEM6, SEM7, SEM8
+};
+
+unsigned int core_str_hash(const char *s) {
+    unsigned int h = 2166136261u;   /* FNV-1a */
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+static void copy_field(char *dst, size_t cap, const char *src) {
+    snprintf(dst, cap, "%s", src);
+}
+
+static int clamp(int v, int lo, int hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+/* ---------- Tables ---------- */
+void core_reset(CoreDb *d) {
+    d->count = 0;
+    d->subject_count = 0;
+    d->enroll_count = 0;
+}
+
+/* copies only the rows in use */
+void core_copy(CoreDb *dst, const CoreDb *src) {
+    dst->version = src->version;
+    dst->subjects_version = src->subjects_version;
+    dst->count = src->count;
+    dst->subject_count = src->subject_count;
+    dst->enroll_count = src->enroll_count;
+    memcpy(dst->subjects, src->subjects, (size_t)src->subject_count * sizeof(SubjectRec));
+    memcpy(dst->students, src->students, (size_t)src->count * sizeof(Student));
+    memcpy(dst->enrollments, src->enrollments, (size_t)src->enroll_count * sizeof(Enrollment));
+}
+
+int core_add_subject(CoreDb *d, const char *id, const char *code, const char *title, int credits, int semester) {
+    if (d->subject_count >= MAX_SUBJECTS) return -1;
+    SubjectRec *r = &d->subjects[d->subject_count];
+    memset(r, 0, sizeof(*r));
+    copy_field(r->id, sizeof(r->id), id);
+    copy_field(r->code, sizeof(r->code), code);
+    copy_field(r->title, sizeof(r->title), title);
+    r->credits = (unsigned char)clamp(credits, 0, 255);
+    r->semester = (unsigned char)(semester >= 1 && semester <= 8 ? semester : 0);
+    return d->subject_count++;
+}
+
+void core_default_subjects(CoreDb *d) {
+    for (int sem = 1; sem <= 8; ++sem) {
+        int pos = 0;
+        for (const SyllabusEntry *e = core_syllabus[sem]; e->title != NULL; ++e) {
+            char code[16];
+            snprintf(code, sizeof(code), "S%02d%02d", sem, ++pos);
+            core_add_subject(d, code, code, e->title, e->credits, sem);
+        }
+    }
+}
+
+static int append_student(CoreDb *d, const Student *s) {
+    if (d->count >= MAX_STUDENTS) return -1;
+    Student *n = &d->students[d->count];
+    *n = *s;
+    n->first = d->enroll_count;
+    n->num_subjects = 0;
+    n->exists = 1;
+    return d->count++;
+}
+
+int core_add_student(CoreDb *d, const Student *s) {
+    for (int i = 0; i < d->count; ++i)
+        if (d->students[i].exists && d->students[i].id == s->id) return -2;
+    return append_student(d, s);
+}
+
+void core_delete_student(CoreDb *d, int slot) {
+    d->students[slot].exists = 0;
+    d->students[slot].num_subjects = 0;
+}
+
+Enrollment *core_enrollment(CoreDb *d, int slot, int subject) {
+    const Student *s = &d->students[slot];
+    Enrollment *e = d->enrollments + s->first;
+    for (int i = 0; i < s->num_subjects; ++i)
+        if (e[i].subject == subject) return &e[i];
+    return NULL;
+}
+
+/* get the student's run to the end of the table with room for one more,
+   moving it there unless it already is; the old place becomes a hole */
+static int enroll_room(CoreDb *d, Student *s) {
+    if (s->num_subjects >= MAX_ENROLLED) return -1;
+    for (int pass = 0; pass < 2; ++pass) {
+        int at_end = s->first + s->num_subjects == d->enroll_count;
+        int need = at_end ? 1 : s->num_subjects + 1;
+        if (d->enroll_count + need <= MAX_ENROLLMENTS) {
+            if (!at_end) {
+                memcpy(d->enrollments + d->enroll_count, d->enrollments + s->first,
+                       (size_t)s->num_subjects * sizeof(Enrollment));
+                s->first = d->enroll_count;
+                d->enroll_count += s->num_subjects;
+            }
+            return 0;
+        }
+        if (pass == 0) core_compact(d);
+    }
+    return -1;
+}
+
+Enrollment *core_enroll(CoreDb *d, int slot, int subject) {
+    Enrollment *e = core_enrollment(d, slot, subject);
+    if (e) return e;
+    Student *s = &d->students[slot];
+    if (enroll_room(d, s) < 0) return NULL;
+    e = &d->enrollments[d->enroll_count++];
+    s->num_subjects++;
+    e->subject = (unsigned short)subject;
+    e->marks = -1;
+    e->held = e->attended = 0;
+    return e;
+}
+
+int core_enroll_upto(CoreDb *d, int slot, int upto) {
+    int added = 0;
+    for (int i = 0; i < d->subject_count; ++i) {
+        int sem = d->subjects[i].semester;
+        if (sem < 1 || sem > upto || core_enrollment(d, slot, i)) continue;
+        if (!core_enroll(d, slot, i)) break;
+        added++;
+    }
+    return added;
+}
+
+/* qsort_r comparators take the CoreDb as their argument rather than from
+   a static, as loads, writers and reports sort in different threads */
+static int cmp_first(const void *a, const void *b, void *db) {
+    const CoreDb *d = db;
+    int x = d->students[*(const int *)a].first, y = d->students[*(const int *)b].first;
+    return (x > y) - (x < y);
+}
+
+void core_compact(CoreDb *d) {
+    int *order = malloc((size_t)(d->count ? d->count : 1) * sizeof(int));
+    if (!order) return;
+    int n = 0;
+    for (int i = 0; i < d->count; ++i)
+        if (d->students[i].num_subjects) order[n++] = i;
+    /* slide runs down in table order, so each only ever moves left */
+    qsort_r(order, (size_t)n, sizeof(int), cmp_first, d);
+    int at = 0;
+    for (int k = 0; k < n; ++k) {
+        Student *s = &d->students[order[k]];
+        if (s->first != at)
+            memmove(d->enrollments + at, d->enrollments + s->first, (size_t)s->num_subjects * sizeof(Enrollment));
+        s->first = at;
+        at += s->num_subjects;
+    }
+    for (int i = 0; i < d->count; ++i)
+        if (!d->students[i].num_subjects) d->students[i].first = at;
+    d->enroll_count = at;
+    free(order);
+}
+
+/* ---------- Results ---------- */
+int core_grade_point(int marks) {
+    if (marks >= 90) return 10;
+    if (marks >= 80) return 9;
+    if (marks >= 70) return 8;
+    if (marks >= 60) return 7;
+    if (marks >= 50) return 6;
+    if (marks >= 40) return 5;
+    return 0;
+}
+
+double core_gpa(const CoreDb *d, int slot, int semester, int *credits) {
+    const Student *s = &d->students[slot];
+    const Enrollment *e = d->enrollments + s->first;
+    double weighted = 0.0;
+    int total = 0;
+    for (int i = 0; i < s->num_subjects; ++i) {
+        const SubjectRec *sub = &d->subjects[e[i].subject];
+        if (e[i].marks < 0 || sub->credits == 0) continue;
+        if (semester && sub->semester != semester) continue;
+        weighted += (double)core_grade_point(e[i].marks) * sub->credits;
+        total += sub->credits;
+    }
+    if (credits) *credits = total;
+    return total ? weighted / total : -1.0;
+}
+
+void core_update_cgpa(CoreDb *d, int slot) {
+    double g = core_gpa(d, slot, 0, NULL);
+    d->students[slot].cgpa = g < 0.0 ? 0.0f : (float)g;
+}
+
+/* ---------- Indexes ---------- */
+/* position holding id's slot, or the empty one where it would go */
+static unsigned int student_probe(const int *slots, const CoreDb *d, int id) {
+    unsigned int h = ((unsigned int)id * 2654435761u) & (INDEX_STUDENT_SLOTS - 1);
+    while (slots[h] >= 0 && d->students[slots[h]].id != id) h = (h + 1) & (INDEX_STUDENT_SLOTS - 1);
+    return h;
+}
+
+void core_index_build(CoreIndex *ix, const CoreDb *d) {
+    for (int i = 0; i < INDEX_STUDENT_SLOTS; ++i) ix->student_slots[i] = -1;
+    for (int i = 0; i < INDEX_SUBJECT_SLOTS; ++i) ix->subject_slots[i] = -1;
+    memset(ix->sem_count, 0, sizeof(ix->sem_count));
+    for (int i = 0; i < d->count; ++i) {
+        if (!d->students[i].exists) continue;
+        unsigned int h = student_probe(ix->student_slots, d, d->students[i].id);
+        if (ix->student_slots[h] < 0) ix->student_slots[h] = i;
+    }
+    for (int i = 0; i < d->subject_count; ++i) {
+        unsigned int h = core_str_hash(d->subjects[i].title) & (INDEX_SUBJECT_SLOTS - 1);
+        while (ix->subject_slots[h] >= 0) h = (h + 1) & (INDEX_SUBJECT_SLOTS - 1);
+        ix->subject_slots[h] = (short)i;
+        int sem = d->subjects[i].semester;
+        if (ix->sem_count[sem] < INDEX_PER_SEM) ix->sem_subjects[sem][ix->sem_count[sem]++] = (short)i;
+    }
+    ix->version = d->version;
+    ix->students = d->count;
+    ix->subjects = d->subject_count;
+    ix->built = 1;
+}
+
+void core_index_refresh(CoreIndex *ix, const CoreDb *d) {
+    if (!ix->built || ix->version != d->version || ix->students != d->count || ix->subjects != d->subject_count)
+        core_index_build(ix, d);
+}
+
+int core_student_slot(const CoreIndex *ix, const CoreDb *d, int id) {
+    int slot = ix->student_slots[student_probe(ix->student_slots, d, id)];
+    return slot >= 0 && d->students[slot].exists ? slot : -1;
+}
+
+int core_subject_find(const CoreIndex *ix, const CoreDb *d, const char *title, int semester) {
+    int best = -1;
+    for (unsigned int h = core_str_hash(title) & (INDEX_SUBJECT_SLOTS - 1); ix->subject_slots[h] >= 0;
+         h = (h + 1) & (INDEX_SUBJECT_SLOTS - 1)) {
+        int i = ix->subject_slots[h];
+        if (strcmp(d->subjects[i].title, title) != 0) continue;
+        if (semester) { if (d->subjects[i].semester == semester) return i; }
+        else if (best < 0 || i < best) best = i;
+    }
+    return best;
+}
+
+/* ---------- CSV storage ---------- */
+static FILE *data_open(int file) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), DATA_DIR "/%s", core_file_names[file]);
+    return fopen(path, "r");
+}
+
+/* split a CSV line in place into at most max fields; returns the count */
+static int csv_split(char *line, char **fields, int max) {
+    int n = 0;
+    line[strcspn(line, "\r\n")] = 0;
+    if (!line[0]) return 0;
+    for (char *p = line; n < max; ) {
+        fields[n++] = p;
+        char *comma = strchr(p, ',');
+        if (!comma) break;
+        *comma = 0;
+        p = comma + 1;
+    }
+    return n;
+}
+
+/* a file being read, for reporting the rows core_load cannot take */
+typedef struct {
+    const char *name;
+    int line;
+    CoreRejectFn rejected;
+} LoadFile;
+
+/* report a row split into n fields by csv_split (joined back for it) */
+static void load_reject(const LoadFile *lf, char **fl, int n, const char *why) {
+    if (!lf->rejected) return;
+    for (int k = 1; k < n; ++k) fl[k][-1] = ',';
+    lf->rejected(lf->name, lf->line, n ? fl[0] : "", why);
+}
+
+/* the whole of s as an integer in [lo, hi]; 0, or -1 if it is anything else */
+static int parse_int(const char *s, long lo, long hi, int *out) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (end == s || *end || errno == ERANGE || v < lo || v > hi) return -1;
+    *out = (int)v;
+    return 0;
+}
+
+/* a marks field, whole or fractional (the console writes %.2f). Marks are
+   kept as whole numbers, so a fraction is rounded to the nearest (72.5 is
+   73); a negative value means not graded. 0, or -1 if it is not a number. */
+static int parse_marks(const char *s, short *out) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || *end || v != v) return -1;
+    *out = (short)(v < 0 ? -1 : v > 100 ? 100 : (int)(v + 0.5));
+    return 0;
+}
+
+/* field text with the separators the format cannot carry blanked out */
+static const char *csv_clean(const char *in, char *out, size_t cap) {
+    size_t j = 0;
+    for (; *in && j + 1 < cap; ++in) out[j++] = (*in == ',' || *in == '\n' || *in == '\r') ? ' ' : *in;
+    out[j] = 0;
+    return out[0] ? out : "-";
+}
+
+/* subject row named by a marks/attendance row: by id through the id hash,
+   then by code or title (files written by older versions), else a new row
+   titled with the name */
+static int load_subject(CoreDb *d, short *ids, const char *name) {
+    unsigned int h = core_str_hash(name) & (INDEX_SUBJECT_SLOTS - 1);
+    for (; ids[h] >= 0; h = (h + 1) & (INDEX_SUBJECT_SLOTS - 1))
+        if (strcmp(d->subjects[ids[h]].id, name) == 0) return ids[h];
+    for (int i = 0; i < d->subject_count; ++i)
+        if (strcmp(d->subjects[i].code, name) == 0 || strcmp(d->subjects[i].title, name) == 0) return i;
+    int i = core_add_subject(d, name, "", name, 0, 0);
+    if (i >= 0) ids[h] = (short)i;
+    return i;
+}
+
+/* ---------- Journal ---------- */
+int core_journal_student(const CoreDb *d, int slot, char *out, size_t cap) {
+    const Student *s = &d->students[slot];
+    char c1[MAX_NAME], c2[MAX_EMAIL], c3[MAX_PHONE], c4[MAX_DEPT], c5[MAX_PASS], c6[MAX_ROLL];
+    int n = snprintf(out, cap, "S,%d,%s,%s,%s,%s,%s,%s,%d,%d,%d\n", s->id, csv_clean(s->roll, c6, sizeof(c6)),
+                     csv_clean(s->name, c1, sizeof(c1)), csv_clean(s->email, c2, sizeof(c2)),
+                     csv_clean(s->phone, c3, sizeof(c3)), csv_clean(s->dept, c4, sizeof(c4)),
+                     csv_clean(s->password, c5, sizeof(c5)), s->age, s->year, s->current_semester);
+    return n < (int)cap ? n : 0;
+}
+
+int core_journal_enrollment(const CoreDb *d, int slot, const Enrollment *e, char *out, size_t cap) {
+    char c1[MAX_SUBID];
+    int n = snprintf(out, cap, "E,%d,%s,%d,%d,%d\n", d->students[slot].id,
+                     csv_clean(d->subjects[e->subject].id, c1, sizeof(c1)), e->marks, e->attended, e->held);
+    return n < (int)cap ? n : 0;
+}
+
+/* apply the journal's post-images in order; ix holds the id index
+   core_load filled in, ids the subject id hash */
+static void journal_replay(CoreDb *d, CoreIndex *ix, short *ids, CoreRejectFn rejected) {
+    char path[PATH_MAX], line[1024], *fl[11];
+    snprintf(path, sizeof(path), DATA_DIR "/%s", CORE_JOURNAL);
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    LoadFile lf = { CORE_JOURNAL, 0, rejected };
+    while (fgets(line, sizeof(line), f)) {
+        ++lf.line;
+        int n = csv_split(line, fl, 11), id;
+        if (!n) continue;
+        if (n < 2 || parse_int(fl[1], 1, INT_MAX, &id) < 0) { load_reject(&lf, fl, n, "no valid id"); continue; }
+        unsigned int h = student_probe(ix->student_slots, d, id);
+        int slot = ix->student_slots[h];
+        if (fl[0][0] == 'S' && n == 11) {
+            int age, year, sem;
+            if (parse_int(fl[8], INT_MIN, INT_MAX, &age) < 0 || parse_int(fl[9], INT_MIN, INT_MAX, &year) < 0 ||
+                parse_int(fl[10], INT_MIN, INT_MAX, &sem) < 0) {
+                load_reject(&lf, fl, n, "age, year or semester is not a number");
+                continue;
+            }
+            Student s;
+            memset(&s, 0, sizeof(s));
+            if (slot >= 0) s = d->students[slot];
+            s.id = id;
+            copy_field(s.roll, sizeof(s.roll), fl[2]);
+            copy_field(s.name, sizeof(s.name), fl[3]);
+            copy_field(s.email, sizeof(s.email), fl[4]);
+            copy_field(s.phone, sizeof(s.phone), fl[5]);
+            copy_field(s.dept, sizeof(s.dept), fl[6]);
+            copy_field(s.password, sizeof(s.password), fl[7]);
+            s.age = (unsigned char)clamp(age, 0, 255);
+            s.year = (unsigned char)clamp(year, 1, 4);
+            s.current_semester = (unsigned char)clamp(sem, 1, 8);
+            if (slot >= 0) d->students[slot] = s;
+            else if ((slot = append_student(d, &s)) >= 0) ix->student_slots[h] = slot;
+            else { load_reject(&lf, fl, n, "roster full"); continue; }
+            core_enroll_upto(d, slot, s.current_semester);
+        } else if (fl[0][0] == 'E' && n == 6) {
+            short marks;
+            int attended, held;
+            if (parse_marks(fl[3], &marks) < 0 || parse_int(fl[4], INT_MIN, INT_MAX, &attended) < 0 ||
+                parse_int(fl[5], INT_MIN, INT_MAX, &held) < 0) {
+                load_reject(&lf, fl, n, "marks or classes is not a number");
+                continue;
+            }
+            if (slot < 0) { load_reject(&lf, fl, n, "no such student"); continue; }
+            int subject = load_subject(d, ids, fl[2]);
+            Enrollment *e = subject >= 0 ? core_enroll(d, slot, subject) : NULL;
+            if (!e) { load_reject(&lf, fl, n, "no room for the subject"); continue; }
+            e->marks = marks;
+            e->attended = (unsigned short)clamp(attended, 0, 65535);
+            e->held = (unsigned short)clamp(held, 0, 65535);
+        } else {
+            load_reject(&lf, fl, n, "malformed record");
+        }
+    }
+    fclose(f);
+}
+
+int core_load(CoreDb *d, const CoreDb *prev, CoreRejectFn rejected) {
+    core_reset(d);
+    CoreIndex *ix = malloc(sizeof(CoreIndex));
+    short *ids = malloc(INDEX_SUBJECT_SLOTS * sizeof(short));
+    if (!ix || !ids) { free(ix); free(ids); return -1; }
+    char line[1024], *fl[7];
+    FILE *f;
+
+    if ((f = data_open(CORE_SUBJECTS))) {
+        LoadFile lf = { core_file_names[CORE_SUBJECTS], 0, rejected };
+        while (fgets(line, sizeof(line), f)) {
+            ++lf.line;
+            int n = csv_split(line, fl, 5), credits, sem;
+            if (!n) continue;
+            if (n < 5) { load_reject(&lf, fl, n, "too few fields"); continue; }
+            if (parse_int(fl[3], INT_MIN, INT_MAX, &credits) < 0 || parse_int(fl[4], INT_MIN, INT_MAX, &sem) < 0) {
+                load_reject(&lf, fl, n, "credits or semester is not a number");
+                continue;
+            }
+            if (core_add_subject(d, fl[0], fl[1], fl[2], credits, sem) < 0) load_reject(&lf, fl, n, "too many subjects");
+        }
+        fclose(f);
+    }
+    if (d->subject_count == 0) core_default_subjects(d);
+    for (int i = 0; i < INDEX_SUBJECT_SLOTS; ++i) ids[i] = -1;
+    for (int i = 0; i < d->subject_count; ++i) {
+        unsigned int h = core_str_hash(d->subjects[i].id) & (INDEX_SUBJECT_SLOTS - 1);
+        while (ids[h] >= 0) h = (h + 1) & (INDEX_SUBJECT_SLOTS - 1);
+        ids[h] = (short)i;
+    }
+
+    /* students, enrolled in their semesters' subjects as registration does;
+       the id index is filled in as they are read */
+    for (int i = 0; i < INDEX_STUDENT_SLOTS; ++i) ix->student_slots[i] = -1;
+    if ((f = data_open(CORE_STUDENTS))) {
+        LoadFile lf = { core_file_names[CORE_STUDENTS], 0, rejected };
+        while (fgets(line, sizeof(line), f)) {
+            ++lf.line;
+            int n = csv_split(line, fl, 7), id, year, sem;
+            if (!n) continue;
+            if (n < 7) { load_reject(&lf, fl, n, "too few fields"); continue; }
+            if (parse_int(fl[0], 1, INT_MAX, &id) < 0) { load_reject(&lf, fl, n, "id is not a positive number"); continue; }
+            if (parse_int(fl[5], INT_MIN, INT_MAX, &year) < 0 || parse_int(fl[6], INT_MIN, INT_MAX, &sem) < 0) {
+                load_reject(&lf, fl, n, "year or semester is not a number");
+                continue;
+            }
+            unsigned int h = student_probe(ix->student_slots, d, id);
+            if (ix->student_slots[h] >= 0) { load_reject(&lf, fl, n, "duplicate id"); continue; }
+            Student s;
+            memset(&s, 0, sizeof(s));
+            s.id = id;
+            copy_field(s.roll, sizeof(s.roll), fl[1]);
+            copy_field(s.name, sizeof(s.name), fl[2]);
+            copy_field(s.email, sizeof(s.email), fl[3]);
+            copy_field(s.phone, sizeof(s.phone), fl[4]);
+            copy_field(s.dept, sizeof(s.dept), "B.Tech CSE");
+            s.year = (unsigned char)clamp(year, 1, 4);
+            s.current_semester = (unsigned char)(sem >= 1 && sem <= 8 ? sem : 1);
+            int slot = append_student(d, &s);
+            if (slot < 0) { load_reject(&lf, fl, n, "roster full, this row and the rest not loaded"); break; }
+            ix->student_slots[h] = slot;
+            core_enroll_upto(d, slot, s.current_semester);
+        }
+        fclose(f);
+    }
+
+    if (prev) {
+        for (int i = 0; i < prev->count; ++i) {
+            int slot = ix->student_slots[student_probe(ix->student_slots, d, prev->students[i].id)];
+            if (slot < 0) continue;
+            Student *s = &d->students[slot];
+            copy_field(s->password, sizeof(s->password), prev->students[i].password);
+            copy_field(s->dept, sizeof(s->dept), prev->students[i].dept);
+            s->age = prev->students[i].age;
+        }
+    }
+    if ((f = data_open(CORE_ACCOUNTS))) {
+        LoadFile lf = { core_file_names[CORE_ACCOUNTS], 0, rejected };
+        while (fgets(line, sizeof(line), f)) {
+            ++lf.line;
+            int n = csv_split(line, fl, 4), id, age;
+            if (!n) continue;
+            if (n < 4) { load_reject(&lf, fl, n, "too few fields"); continue; }
+            if (parse_int(fl[0], 1, INT_MAX, &id) < 0) { load_reject(&lf, fl, n, "id is not a positive number"); continue; }
+            if (parse_int(fl[2], INT_MIN, INT_MAX, &age) < 0) { load_reject(&lf, fl, n, "age is not a number"); continue; }
+            int slot = ix->student_slots[student_probe(ix->student_slots, d, id)];
+            if (slot < 0) { load_reject(&lf, fl, n, "no such student"); continue; }
+            Student *s = &d->students[slot];
+            copy_field(s->password, sizeof(s->password), fl[1]);
+            s->age = (unsigned char)clamp(age, 0, 255);
+            copy_field(s->dept, sizeof(s->dept), fl[3]);
+        }
+        fclose(f);
+    }
+
+    if ((f = data_open(CORE_MARKS))) {
+        LoadFile lf = { core_file_names[CORE_MARKS], 0, rejected };
+        while (fgets(line, sizeof(line), f)) {
+            ++lf.line;
+            int n = csv_split(line, fl, 3), id;
+            short marks;
+            if (!n) continue;
+            if (n < 3) { load_reject(&lf, fl, n, "too few fields"); continue; }
+            if (parse_int(fl[0], 1, INT_MAX, &id) < 0) { load_reject(&lf, fl, n, "id is not a positive number"); continue; }
+            if (parse_marks(fl[2], &marks) < 0) { load_reject(&lf, fl, n, "marks is not a number"); continue; }
+            int slot = ix->student_slots[student_probe(ix->student_slots, d, id)];
+            if (slot < 0) { load_reject(&lf, fl, n, "no such student"); continue; }
+            int subject = load_subject(d, ids, fl[1]);
+            Enrollment *e = subject >= 0 ? core_enroll(d, slot, subject) : NULL;
+            if (!e) { load_reject(&lf, fl, n, "no room for the subject"); continue; }
+            e->marks = marks;
+        }
+        fclose(f);
+    }
+    if ((f = data_open(CORE_ATTS))) {
+        LoadFile lf = { core_file_names[CORE_ATTS], 0, rejected };
+        while (fgets(line, sizeof(line), f)) {
+            ++lf.line;
+            int n = csv_split(line, fl, 4), id, attended, held;
+            if (!n) continue;
+            if (n < 4) { load_reject(&lf, fl, n, "too few fields"); continue; }
+            if (parse_int(fl[0], 1, INT_MAX, &id) < 0) { load_reject(&lf, fl, n, "id is not a positive number"); continue; }
+            if (parse_int(fl[2], INT_MIN, INT_MAX, &attended) < 0 || parse_int(fl[3], INT_MIN, INT_MAX, &held) < 0) {
+                load_reject(&lf, fl, n, "classes is not a number");
+                continue;
+            }
+            int slot = ix->student_slots[student_probe(ix->student_slots, d, id)];
+            if (slot < 0) { load_reject(&lf, fl, n, "no such student"); continue; }
+            int subject = load_subject(d, ids, fl[1]);
+            Enrollment *e = subject >= 0 ? core_enroll(d, slot, subject) : NULL;
+            if (!e) { load_reject(&lf, fl, n, "no room for the subject"); continue; }
+            e->attended = (unsigned short)clamp(attended, 0, 65535);
+            e->held = (unsigned short)clamp(held, 0, 65535);
+        }
+        fclose(f);
+    }
+    journal_replay(d, ix, ids, rejected);
+    for (int i = 0; i < d->count; ++i) core_update_cgpa(d, i);
+    free(ix);
+    free(ids);
+    return 0;
+}
+
+static FILE *save_open(int file, char *tmp, size_t cap) {
+    snprintf(tmp, cap, DATA_DIR "/.%s.tmp", core_file_names[file]);
+    return fopen(tmp, "w");
+}
+
+static void save_subjects(FILE *f, const CoreDb *d) {
+    char c1[MAX_TITLE];
+    for (int i = 0; i < d->subject_count && f; ++i) {
+        const SubjectRec *r = &d->subjects[i];
+        fprintf(f, "%s,", csv_clean(r->id, c1, sizeof(c1)));
+        fprintf(f, "%s,", csv_clean(r->code, c1, sizeof(c1)));
+        fprintf(f, "%s,%d,%d\n", csv_clean(r->title, c1, sizeof(c1)), r->credits, r->semester);
+    }
+}
+
+/* a student's rows in every file but subjects; e is its enrollment run,
+   its subjects rows of d */
+static void save_student(FILE **f, const CoreDb *d, const Student *s, const Enrollment *e) {
+    char c1[MAX_TITLE], c2[MAX_EMAIL], c3[MAX_PHONE], c4[MAX_DEPT];
+    if (f[CORE_STUDENTS]) {
+        fprintf(f[CORE_STUDENTS], "%d,%s,", s->id, csv_clean(s->roll, c1, sizeof(c1)));
+        fprintf(f[CORE_STUDENTS], "%s,%s,%s,%d,%d\n", csv_clean(s->name, c1, sizeof(c1)),
+                csv_clean(s->email, c2, sizeof(c2)), csv_clean(s->phone, c3, sizeof(c3)), s->year, s->current_semester);
+    }
+    if (f[CORE_ACCOUNTS])
+        fprintf(f[CORE_ACCOUNTS], "%d,%s,%d,%s\n", s->id, csv_clean(s->password, c1, sizeof(c1)), s->age,
+                csv_clean(s->dept, c4, sizeof(c4)));
+    /* enrollments loading recreates on its own (ungraded, no classes,
+       semester up to the current one) need no rows */
+    for (int j = 0; j < s->num_subjects; ++j) {
+        const SubjectRec *r = &d->subjects[e[j].subject];
+        int implied = r->semester >= 1 && r->semester <= s->current_semester;
+        if (implied && e[j].marks < 0 && !e[j].held) continue;
+        const char *sid = csv_clean(r->id, c1, sizeof(c1));
+        if (f[CORE_MARKS] && (e[j].marks >= 0 || !implied))
+            fprintf(f[CORE_MARKS], "%d,%s,%.2f\n", s->id, sid, (double)e[j].marks);
+        if (f[CORE_ATTS] && e[j].held) fprintf(f[CORE_ATTS], "%d,%s,%d,%d\n", s->id, sid, e[j].attended, e[j].held);
+    }
+}
+
+/* close the temporaries of the files asked for and rename them into
+   place; once all of them made it, the journal has nothing left to add
+   unless some were not asked for */
+static int save_commit(FILE **f, char (*tmp)[PATH_MAX], unsigned int files, void (*saved)(int file)) {
+    int all = 1;
+    char path[PATH_MAX];
+    for (int i = 0; i < CORE_FILES; ++i) {
+        if (!(files & (1u << i))) continue;
+        if (!f[i]) { all = 0; continue; }
+        snprintf(path, sizeof(path), DATA_DIR "/%s", core_file_names[i]);
+        if (fclose(f[i]) == 0 && rename(tmp[i], path) == 0) { if (saved) saved(i); }
+        else { unlink(tmp[i]); all = 0; }
+    }
+    if (all && files == CORE_ALL_FILES) {
+        snprintf(path, sizeof(path), DATA_DIR "/%s", CORE_JOURNAL);
+        unlink(path);
+    }
+    return all ? 0 : -1;
+}
+
+int core_save_files(const CoreDb *d, unsigned int files, void (*saved)(int file)) {
+    mkdir(DATA_DIR, 0755);
+    char tmp[CORE_FILES][PATH_MAX];
+    FILE *f[CORE_FILES];
+    for (int i = 0; i < CORE_FILES; ++i) f[i] = files & (1u << i) ? save_open(i, tmp[i], PATH_MAX) : NULL;
+    save_subjects(f[CORE_SUBJECTS], d);
+    for (int i = 0; i < d->count; ++i)
+        if (d->students[i].exists) save_student(f, d, &d->students[i], d->enrollments + d->students[i].first);
+    return save_commit(f, tmp, files, saved);
+}
+
+void core_save(const CoreDb *d, void (*saved)(int file)) {
+    core_save_files(d, CORE_ALL_FILES, saved);
+}
+
+/* ---------- Generator ----------
+   Student i of a seed is a pure function of (seed, i), and its marks and
+   attendance in a subject of (seed, i, subject row), so the in-memory and
+   CSV paths agree row for row and any prefix of a big roster is the
+   smaller roster. Randomness is splitmix64; normal deviates are the sum
+   of twelve uniforms, which is close enough here and needs no libm.
+
+   A student has an ability (mean mark) and a diligence (attendance rate).
+   Subjects of past semesters are graded and fully held (36-48 classes,
+   fixed per subject, with a per-subject difficulty shifting marks); the
+   current semester is part way through: classes held in proportion, and
+   some subjects already graded. */
+#define GEN_ID_BASE 50000000
+
+typedef struct { unsigned long long s; } GenRng;
+
+typedef struct {
+    double ability;                 /* mean mark */
+    double diligence;               /* share of classes attended */
+    double progress;                /* how far the current semester is */
+} GenTraits;
+
+static const char *const GEN_FIRST[] = {
+    "Aarav", "Vivaan", "Aditya", "Ishaan", "Arjun", "Kabir", "Rohan", "Karan", "Dev", "Rahul", "Nikhil", "Yash",
+    "Ananya", "Diya", "Isha", "Kavya", "Meera", "Priya", "Riya", "Sneha", "Tanvi", "Pooja", "Neha", "Aisha",
+};
+static const char *const GEN_LAST[] = {
+    "Sharma", "Verma", "Gupta", "Singh", "Kumar", "Patel", "Reddy", "Nair", "Iyer", "Das", "Bose", "Mehta",
+    "Joshi", "Rao", "Khan", "Chopra", "Malhotra", "Kapoor", "Bhat", "Menon", "Pillai", "Saxena", "Agarwal", "Jain",
+};
+#define GEN_COUNT(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static unsigned long long gen_mix(unsigned long long x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static unsigned long long gen_next(GenRng *r) {
+    r->s += 0x9E3779B97F4A7C15ULL;
+    return gen_mix(r->s);
+}
+
+static double gen_unit(GenRng *r) {
+    return (double)(gen_next(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double gen_normal(GenRng *r) {
+    double sum = 0;
+    for (int k = 0; k < 12; ++k) sum += gen_unit(r);
+    return sum - 6.0;
+}
+
+static double gen_clamp(double v, double lo, double hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+static void gen_student(unsigned long long seed, long i, Student *s, GenTraits *t) {
+    GenRng r = { gen_mix(seed ^ gen_mix((unsigned long long)i + 1)) };
+    memset(s, 0, sizeof(*s));
+    s->id = GEN_ID_BASE + (int)i;
+    const char *first = GEN_FIRST[gen_next(&r) % GEN_COUNT(GEN_FIRST)];
+    const char *last = GEN_LAST[gen_next(&r) % GEN_COUNT(GEN_LAST)];
+    snprintf(s->roll, sizeof(s->roll), "R%08d", (int)(i + 1));
+    snprintf(s->name, sizeof(s->name), "%s %s", first, last);
+    snprintf(s->email, sizeof(s->email), "%s.%s%ld@example.edu", first, last, i + 1);
+    for (char *p = s->email; *p; ++p) if (*p >= 'A' && *p <= 'Z') *p = (char)(*p - 'A' + 'a');
+    snprintf(s->phone, sizeof(s->phone), "9%09llu", gen_next(&r) % 1000000000ULL);
+    unsigned int dept = (unsigned int)(gen_next(&r) % 10);
+    copy_field(s->dept, sizeof(s->dept), dept < 5 ? "B.Tech CSE" : dept < 7 ? "B.Tech IT" : dept < 9 ? "B.Tech ECE" : "B.Tech ME");
+    snprintf(s->password, sizeof(s->password), "pw%d", s->id);
+    s->year = (unsigned char)(1 + gen_next(&r) % 4);
+    s->current_semester = (unsigned char)(2 * s->year - 1 + gen_next(&r) % 2);
+    s->age = (unsigned char)(16 + s->year + gen_next(&r) % 3);
+    t->ability = gen_clamp(68.0 + 12.0 * gen_normal(&r), 25.0, 98.0);
+    t->diligence = gen_clamp(0.84 + 0.09 * gen_normal(&r), 0.35, 1.0);
+    t->progress = gen_unit(&r);
+}
+
+static void gen_enrollment(unsigned long long seed, long i, const GenTraits *t, const Student *s,
+                           const SubjectRec *sub, int row, Enrollment *e) {
+    GenRng r = { gen_mix(seed ^ gen_mix(((unsigned long long)i << 16) + (unsigned long long)row + 0x51ED)) };
+    unsigned long long per_subject = gen_mix(seed ^ (0xC0FFEEULL + (unsigned long long)row));
+    int difficulty = (int)(per_subject % 13) - 8;                  /* -8 .. +4 */
+    int held = 36 + (int)((per_subject >> 8) % 13);                /* a full semester */
+    int past = sub->semester < s->current_semester;
+    if (!past) held = (int)(held * t->progress);
+    double rate = gen_clamp(t->diligence + 0.06 * gen_normal(&r), 0.0, 1.0);
+    e->held = (unsigned short)held;
+    e->attended = (unsigned short)clamp((int)(held * rate + 0.5), 0, held);
+    e->marks = -1;
+    if (past || gen_unit(&r) < t->progress * 0.5) {
+        double mk = t->ability + difficulty + 9.0 * gen_normal(&r) + (rate - 0.75) * 20.0;
+        e->marks = (short)gen_clamp(mk + 0.5, 0.0, 100.0);
+    }
+}
+
+int core_generate(CoreDb *d, int n, unsigned long long seed) {
+    core_reset(d);
+    core_default_subjects(d);
+    for (int i = 0; i < n; ++i) {
+        Student s;
+        GenTraits t;
+        gen_student(seed, i, &s, &t);
+        int slot = append_student(d, &s);
+        if (slot < 0) break;
+        core_enroll_upto(d, slot, s.current_semester);
+        Enrollment *e = d->enrollments + d->students[slot].first;
+        for (int k = 0; k < d->students[slot].num_subjects; ++k)
+            gen_enrollment(seed, i, &t, &s, &d->subjects[e[k].subject], e[k].subject, &e[k]);
+        core_update_cgpa(d, slot);
+    }
+    return d->count;
+}
+
+int core_generate_csv(long n, unsigned long long seed) {
+    CoreDb *d = malloc(sizeof(CoreDb));
+    if (!d) return -1;
+    core_reset(d);
+    core_default_subjects(d);
+    mkdir(DATA_DIR, 0755);
+    char tmp[CORE_FILES][PATH_MAX];
+    FILE *f[CORE_FILES];
+    for (int i = 0; i < CORE_FILES; ++i) f[i] = save_open(i, tmp[i], PATH_MAX);
+    save_subjects(f[CORE_SUBJECTS], d);
+    Enrollment run[MAX_ENROLLED];
+    for (long i = 0; i < n; ++i) {
+        Student s;
+        GenTraits t;
+        gen_student(seed, i, &s, &t);
+        int k = 0;
+        for (int row = 0; row < d->subject_count && k < MAX_ENROLLED; ++row) {
+            const SubjectRec *sub = &d->subjects[row];
+            if (sub->semester < 1 || sub->semester > s.current_semester) continue;
+            run[k].subject = (unsigned short)row;
+            gen_enrollment(seed, i, &t, &s, sub, row, &run[k++]);
+        }
+        s.num_subjects = (unsigned char)k;
+        save_student(f, d, &s, run);
+    }
+    free(d);
+    return save_commit(f, tmp, CORE_ALL_FILES, NULL);
+}
+
+/* ---------- Reports ---------- */
+static int cmp_id(const void *a, const void *b, void *db) {
+    const CoreDb *d = db;
+    int x = d->students[*(const int *)a].id, y = d->students[*(const int *)b].id;
+    return (x > y) - (x < y);
+}
+
+static int cmp_name(const void *a, const void *b, void *db) {
+    const CoreDb *d = db;
+    return strcasecmp(d->students[*(const int *)a].name, d->students[*(const int *)b].name);
+}
+
+int core_sorted_slots(const CoreDb *d, int order, int *out) {
+    int n = 0;
+    for (int i = 0; i < d->count; ++i) if (d->students[i].exists) out[n++] = i;
+    qsort_r(out, (size_t)n, sizeof(int), order == CORE_BY_NAME ? cmp_name : cmp_id, (void *)d);
+    return n;
+}
+
+/* one text field of an export, then sep; quoted (RFC 4180) when it holds a
+   comma, quote or line break, so a spreadsheet keeps the columns */
+static void csv_put(FILE *f, const char *s, char sep) {
+    if (!s[strcspn(s, ",\"\r\n")]) {
+        fprintf(f, "%s%c", s, sep);
+        return;
+    }
+    putc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"') putc('"', f);
+        putc(*s, f);
+    }
+    putc('"', f);
+    putc(sep, f);
+}
+
+void core_export_csv(const CoreDb *d, FILE *f) {
+    fprintf(f, "sap,roll,name,email,phone,year,current_sem,cgpa\n");
+    for (int i = 0; i < d->count; ++i) {
+        const Student *s = &d->students[i];
+        if (!s->exists) continue;
+        double cg = core_gpa(d, i, 0, NULL);
+        if (cg < 0.0) cg = 0.0;
+        fprintf(f, "%d,", s->id);
+        csv_put(f, s->roll, ',');
+        csv_put(f, s->name, ',');
+        csv_put(f, s->email, ',');
+        csv_put(f, s->phone, ',');
+        fprintf(f, "%d,%d,%.3f\n", s->year, s->current_semester, cg);
+    }
+}
+
+void core_report_card(const CoreDb *d, int slot, const char *exam, time_t when, FILE *f) {
+    const Student *s = &d->students[slot];
+    fprintf(f, "------------------------------------------------------------\n");
+    fprintf(f, "           XYZ INSTITUTE OF TECHNOLOGY (Demo College)\n");
+    fprintf(f, "           Student Report Card\n");
+    fprintf(f, "------------------------------------------------------------\n\n");
+    fprintf(f, "Name: %s\nSAP ID: %d\nRoll: %s\nEmail: %s\nPhone: %s\nYear: %d\nSemester: %d\nExam: %s\nGenerated: %s\n",
+            s->name, s->id, s->roll, s->email, s->phone, s->year, s->current_semester, exam, ctime(&when));
+    fprintf(f, "------------------------------------------------------------\n");
+    fprintf(f, "| %-3s | %-40s | %6s | %6s |\n", "No", "Subject", "Credits", "Marks");
+    fprintf(f, "------------------------------------------------------------\n");
+    const Enrollment *en = d->enrollments + s->first;
+    for (int k = 0; k < s->num_subjects; k++) {
+        const SubjectRec *sub = &d->subjects[en[k].subject];
+        char mkstr[32];
+        if (en[k].marks >= 0) snprintf(mkstr, sizeof(mkstr), "%d", en[k].marks);
+        else strcpy(mkstr, "N/A");
+        fprintf(f, "| %3d | %-40s | %6d | %6s |\n", k + 1, sub->title, sub->credits, mkstr);
+    }
+    fprintf(f, "------------------------------------------------------------\n\n");
+    fprintf(f, "Semester-wise SGPA:\n");
+    for (int sem = 1; sem <= s->current_semester; ++sem) {
+        double sg = core_gpa(d, slot, sem, NULL);
+        if (sg < 0.0) fprintf(f, "  Sem %d: N/A\n", sem);
+        else fprintf(f, "  Sem %d: %.3f\n", sem, sg);
+    }
+    double cg = core_gpa(d, slot, 0, NULL);
+    if (cg < 0.0) fprintf(f, "\nCGPA: N/A\n");
+    else fprintf(f, "\nCGPA (credit-weighted): %.3f\n", cg);
+    fprintf(f, "\nRemarks: ___________________________\n\n");
+    fprintf(f, "------------------------------------------------------------\n");
+    fprintf(f, "Principal / Controller of Examinations\n");
+}
+
+/* ---------- Misc ---------- */
+int core_admin_auth(const char *user, const char *pass) {
+    return strcmp(user, "admin") == 0 && strcmp(pass, "admin123") == 0;
+}
@@ -0,0 +1,215 @@
+/*
+  student_core.h
+  Student Record & Result Management System - core data model
+
+  One record layout and one API for both front ends: the console program
+  (student_system.c) and the web server (student_system_web.c). Everything
+  lives in a flat CoreDb - fixed-size tables and counts, no pointers - so a
+  CoreDb can be copied with memcpy and shared between processes as is.
+
+  Subjects are rows of a subject table. What a student takes is a run of
+  compact Enrollment records (subject, marks, attendance) in one enrollment
+  table; the student record only holds where its run starts and how long
+  it is.
+*/
+#ifndef STUDENT_CORE_H
+#define STUDENT_CORE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+/* ---------- Config & Limits ---------- */
+#define DATA_DIR "data"
+#define REPORTS_DIR "reports"
+
+#define MAX_STUDENTS 2048
+#define MAX_SUBJECTS 512                    /* subject table rows */
+#define MAX_ENROLLED 64                     /* subjects one student can take */
+#define MAX_ENROLLMENTS (MAX_STUDENTS * 40) /* enrollment table, holes included */
+
+#define MAX_NAME 64
+#define MAX_EMAIL 64
+#define MAX_PHONE 16
+#define MAX_ROLL 16
+#define MAX_DEPT 32
+#define MAX_PASS 48
+#define MAX_TITLE 80
+#define MAX_CODE 12
+#define MAX_SUBID 24
+
+/* the files under DATA_DIR; core_file_names is indexed by these */
+enum { CORE_STUDENTS, CORE_SUBJECTS, CORE_MARKS, CORE_ATTS, CORE_ACCOUNTS, CORE_FILES };
+#define CORE_ALL_FILES ((1u << CORE_FILES) - 1)   /* bit 1 << CORE_* per file */
+extern const char *const core_file_names[CORE_FILES];
+
+/* ---------- Records ---------- */
+typedef struct {
+    char id[MAX_SUBID];             /* what marks and attendance rows refer to */
+    char code[MAX_CODE];
+    char title[MAX_TITLE];
+    unsigned char credits;
+    unsigned char semester;         /* 1..8, 0 = not tied to a semester */
+} SubjectRec;
+
+typedef struct {
+    unsigned short subject;         /* row in CoreDb.subjects */
+    short marks;                    /* 0-100 whole marks, -1 = not graded yet */
+    unsigned short held;            /* classes held */
+    unsigned short attended;
+} Enrollment;
+
+typedef struct {
+    int id;                         /* SAP id */
+    int first;                      /* enrollments[first .. first + num_subjects) */
+    char roll[MAX_ROLL];
+    char name[MAX_NAME];
+    char email[MAX_EMAIL];
+    char phone[MAX_PHONE];
+    char dept[MAX_DEPT];
+    char password[MAX_PASS];
+    unsigned char age;
+    unsigned char year;             /* 1..4 */
+    unsigned char current_semester; /* 1..8 */
+    unsigned char num_subjects;
+    unsigned char exists;           /* 0 once deleted; slots are never reused */
+    float cgpa;                     /* credit-weighted over graded subjects, as last computed */
+} Student;
+
+typedef struct {
+    unsigned long long version;     /* left to the owner (the web server bumps it per publish) */
+    unsigned long long subjects_version;    /* also the owner's: version the subject table changed at */
+    int count;                      /* student slots in use */
+    int subject_count;
+    int enroll_count;               /* enrollment slots in use */
+    SubjectRec subjects[MAX_SUBJECTS];
+    Student students[MAX_STUDENTS];
+    Enrollment enrollments[MAX_ENROLLMENTS];
+} CoreDb;
+
+/* default syllabus: per-semester subject lists and credits */
+typedef struct { const char *title; int credits; } SyllabusEntry;
+extern const SyllabusEntry *const core_syllabus[9];
+
+/* ---------- Tables ---------- */
+void core_reset(CoreDb *d);
+void core_copy(CoreDb *dst, const CoreDb *src);
+
+/* append a subject row; its index, or -1 when the table is full */
+int core_add_subject(CoreDb *d, const char *id, const char *code, const char *title, int credits, int semester);
+/* the default syllabus as subject rows S<sem><pos> */
+void core_default_subjects(CoreDb *d);
+
+/* append a student (enrollments are added separately); its slot, -2 if
+   the id is taken, -1 if the table is full */
+int core_add_student(CoreDb *d, const Student *s);
+void core_delete_student(CoreDb *d, int slot);
+
+/* the student's enrollment in a subject row, or NULL */
+Enrollment *core_enrollment(CoreDb *d, int slot, int subject);
+/* enroll (ungraded, no attendance) unless already enrolled; NULL when full */
+Enrollment *core_enroll(CoreDb *d, int slot, int subject);
+/* enroll in every subject row of semesters 1..upto; how many were added */
+int core_enroll_upto(CoreDb *d, int slot, int upto);
+/* squeeze the holes moved runs leave out of the enrollment table */
+void core_compact(CoreDb *d);
+
+/* ---------- Results ---------- */
+/* grade point of a mark: 10 from 90, 9 from 80 ... 5 from 40, else 0 */
+int core_grade_point(int marks);
+/* credit-weighted grade point over the graded subjects of one semester
+   (0 = all of them); -1 if none is graded. credits gets the graded credits. */
+double core_gpa(const CoreDb *d, int slot, int semester, int *credits);
+/* recompute a student's stored cgpa */
+void core_update_cgpa(CoreDb *d, int slot);
+
+/* ---------- Indexes ----------
+   Student id -> slot and subject title -> rows, as open-addressing hashes,
+   plus the subject rows of each semester in table order. An index records
+   what it was built from; core_index_refresh rebuilds it only when the
+   CoreDb has another version or has grown since. */
+#define INDEX_STUDENT_SLOTS 4096            /* power of two, >= 2x MAX_STUDENTS */
+#define INDEX_SUBJECT_SLOTS 1024            /* power of two, >= 2x MAX_SUBJECTS */
+#define INDEX_PER_SEM 32
+
+typedef struct {
+    unsigned long long version;
+    int built;
+    int students, subjects;         /* counts indexed */
+    int student_slots[INDEX_STUDENT_SLOTS];
+    short subject_slots[INDEX_SUBJECT_SLOTS];
+    short sem_subjects[9][INDEX_PER_SEM];
+    int sem_count[9];
+} CoreIndex;
+
+void core_index_build(CoreIndex *ix, const CoreDb *d);
+void core_index_refresh(CoreIndex *ix, const CoreDb *d);
+/* slot of a live student, or -1 */
+int core_student_slot(const CoreIndex *ix, const CoreDb *d, int id);
+/* subject row by title, in a given semester (0 = the first with that
+   title), or -1 */
+int core_subject_find(const CoreIndex *ix, const CoreDb *d, const char *title, int semester);
+
+/* ---------- Storage ----------
+   CSV files under DATA_DIR: students, subjects, marks and attendance in
+   the console's formats, plus accounts.csv for password, age and
+   department. */
+/* a row core_load could not take (a non-numeric id or count, an unknown
+   student, a duplicate): file name, line number from 1, the row, why */
+typedef void (*CoreRejectFn)(const char *file, int line, const char *row, const char *why);
+/* load everything, the journal last; fields of students missing from
+   accounts.csv are kept from prev when given. Every row left out is
+   reported to rejected (may be NULL), as the next core_save will not
+   write it back. Marks are whole numbers: fractional ones in the files
+   are rounded to the nearest. 0, or -1 when out of memory. */
+int core_load(CoreDb *d, const CoreDb *prev, CoreRejectFn rejected);
+/* write everything, each file through a temporary and rename; saved (may
+   be NULL) is called with each file once it is in place. The journal is
+   removed when all of them made it. */
+void core_save(const CoreDb *d, void (*saved)(int file));
+/* the same for only the files whose bit is set in files; the journal is
+   then left alone, as it still holds what the others are missing. 0 once
+   every file asked for is in place, else -1. */
+int core_save_files(const CoreDb *d, unsigned int files, void (*saved)(int file));
+
+/* ---------- Reports ----------
+   What the console prints and writes out, shared so the bench times the
+   same code. */
+enum { CORE_BY_ID, CORE_BY_NAME };
+/* live student slots into out (room for d->count), sorted by id or by name
+   ignoring case; how many */
+int core_sorted_slots(const CoreDb *d, int order, int *out);
+/* every live student as CSV, header line first; text fields are quoted
+   (RFC 4180) where they need it */
+void core_export_csv(const CoreDb *d, FILE *f);
+/* one student's report card as text */
+void core_report_card(const CoreDb *d, int slot, const char *exam, time_t when, FILE *f);
+
+/* ---------- Generator ----------
+   Deterministic synthetic rosters for benchmarks and demos: n students
+   over years 1-4 and semesters 1-8 on the default syllabus, with marks and
+   attendance drawn per student and subject. The same seed gives the same
+   roster, and a smaller n gives its prefix. */
+/* into memory (at most MAX_STUDENTS); the count generated */
+int core_generate(CoreDb *d, int n, unsigned long long seed);
+/* straight to the CSV files under DATA_DIR, streamed, so n is not bound by
+   MAX_STUDENTS (core_load takes the first MAX_STUDENTS); 0, or -1 */
+int core_generate_csv(long n, unsigned long long seed);
+
+/* ---------- Journal ----------
+   DATA_DIR/CORE_JOURNAL holds what changed since the CSV files were last
+   written, one line per student record or enrollment. A line carries the
+   values after the change, not the change itself (attended 31 of 40, not
+   "one more class"), so replaying a line twice does no harm: core_load
+   replays the journal over the CSV files, and core_save removes it once
+   every file is in place. Writers append lines built by these; each
+   returns the line's length, 0 if it does not fit in cap. */
+#define CORE_JOURNAL "journal.log"
+int core_journal_student(const CoreDb *d, int slot, char *out, size_t cap);
+int core_journal_enrollment(const CoreDb *d, int slot, const Enrollment *e, char *out, size_t cap);
+
+/* ---------- Misc ---------- */
+int core_admin_auth(const char *user, const char *pass);
+unsigned int core_str_hash(const char *s);
+
+#endif
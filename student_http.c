@@ -0,0 +1,522 @@
+/* student_http.c
+   HTTP plumbing of the web server (student_http.h): request arena, form
+   decoding, request parser, route trie and session table. Nothing here
+   touches a socket or the roster, so the tests link it directly.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/random.h>
+
+#include "student_core.h"
+#include "student_http.h"
+
+/* ---------- Request arena ---------- */
+#define ARENA_ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+static void *arena_alloc_large(Arena *a, size_t n) {
+    ArenaLarge *l = malloc(sizeof(ArenaLarge) + n);
+    if (!l) return NULL;
+    l->size = n;
+    l->next = a->large;
+    a->large = l;
+    return l->data;
+}
+
+void *arena_alloc(Arena *a, size_t n) {
+    n = ARENA_ALIGN(n ? n : 1);
+    if (n > ARENA_LARGE) return arena_alloc_large(a, n);
+    ArenaBlock *b = a->head;
+    if (!b || b->cap - b->used < n) {
+        b = malloc(sizeof(ArenaBlock) + ARENA_BLOCK);
+        if (!b) return NULL;
+        b->next = a->head; b->used = 0; b->cap = ARENA_BLOCK;
+        a->head = b;
+    }
+    char *p = b->data + b->used;
+    b->used += n;
+    a->last = p;
+    return p;
+}
+
+/* grow an allocation made from this arena, in place when it is the newest one */
+void *arena_grow(Arena *a, void *p, size_t oldn, size_t newn) {
+    if (!p) return arena_alloc(a, newn);
+    ArenaBlock *b = a->head;
+    if (p == a->last && b) {
+        size_t off = (size_t)((char *)p - b->data);
+        if (off + ARENA_ALIGN(newn) <= b->cap && ARENA_ALIGN(newn) <= ARENA_LARGE) {
+            b->used = off + ARENA_ALIGN(newn);
+            return p;
+        }
+    }
+    for (ArenaLarge **lp = &a->large; *lp; lp = &(*lp)->next) {
+        if ((*lp)->data != p) continue;
+        ArenaLarge *next = (*lp)->next;
+        ArenaLarge *nl = realloc(*lp, sizeof(ArenaLarge) + newn);
+        if (!nl) return NULL;
+        nl->size = newn; nl->next = next;
+        *lp = nl;
+        return nl->data;
+    }
+    void *np = arena_alloc(a, newn);
+    if (np) memcpy(np, p, oldn < newn ? oldn : newn);
+    return np;
+}
+
+/* drop everything but the oldest block, which is kept for reuse */
+void arena_reset(Arena *a) {
+    while (a->large) { ArenaLarge *n = a->large->next; free(a->large); a->large = n; }
+    while (a->head && a->head->next) { ArenaBlock *n = a->head->next; free(a->head); a->head = n; }
+    if (a->head) a->head->used = 0;
+    a->last = NULL;
+}
+
+/* ---------- Form / query decoding ---------- */
+static int hexval(unsigned char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* decode src[0..n) ('+' and %XX) into a fresh arena string */
+static char *form_decode(Arena *a, const char *src, size_t n) {
+    char *out = arena_alloc(a, n + 1);
+    if (!out) return NULL;
+    size_t j = 0;
+    for (size_t i = 0; i < n; ++i) {
+        char c = src[i];
+        if (c == '+') c = ' ';
+        else if (c == '%' && i + 2 < n) {
+            int hi = hexval((unsigned char)src[i + 1]);
+            int lo = hexval((unsigned char)src[i + 2]);
+            if (hi >= 0 && lo >= 0) { c = (char)(hi * 16 + lo); i += 2; }
+        }
+        out[j++] = c;
+    }
+    out[j] = 0;
+    return out;
+}
+
+static int form_grow(FormTable *t) {
+    int ncap = t->cap ? t->cap * 2 : 16;
+    FormField *nf = arena_alloc(t->arena, sizeof(FormField) * (size_t)ncap);
+    int nslots = ncap * 2;
+    int *ns = arena_alloc(t->arena, sizeof(int) * (size_t)nslots);
+    if (!nf || !ns) return -1;
+    if (t->nfields) memcpy(nf, t->fields, sizeof(FormField) * (size_t)t->nfields);
+    for (int i = 0; i < nslots; ++i) ns[i] = -1;
+    for (int i = 0; i < t->nfields; ++i) {
+        unsigned int h = nf[i].hash & (unsigned int)(nslots - 1);
+        while (ns[h] >= 0) h = (h + 1) & (unsigned int)(nslots - 1);
+        ns[h] = i;
+    }
+    t->fields = nf; t->cap = ncap; t->slots = ns; t->nslots = nslots;
+    return 0;
+}
+
+static int form_slot(const FormTable *t, const char *key, unsigned int hash) {
+    if (!t->nslots) return -1;
+    unsigned int h = hash & (unsigned int)(t->nslots - 1);
+    while (t->slots[h] >= 0) {
+        const FormField *f = &t->fields[t->slots[h]];
+        if (f->hash == hash && strcmp(f->key, key) == 0) return t->slots[h];
+        h = (h + 1) & (unsigned int)(t->nslots - 1);
+    }
+    return -1;
+}
+
+static void form_add(FormTable *t, const char *key, const char *value) {
+    unsigned int hash = core_str_hash(key);
+    int idx = form_slot(t, key, hash);
+    if (idx < 0) {
+        if (t->nfields == t->cap && form_grow(t) < 0) return;
+        idx = t->nfields++;
+        FormField *f = &t->fields[idx];
+        f->key = key; f->hash = hash; f->first = f->last = NULL; f->count = 0;
+        unsigned int h = hash & (unsigned int)(t->nslots - 1);
+        while (t->slots[h] >= 0) h = (h + 1) & (unsigned int)(t->nslots - 1);
+        t->slots[h] = idx;
+    }
+    FormValue *v = arena_alloc(t->arena, sizeof(FormValue));
+    if (!v) return;
+    FormField *f = &t->fields[idx];
+    v->value = value; v->next = NULL;
+    if (f->last) f->last->next = v; else f->first = v;
+    f->last = v;
+    f->count++;
+}
+
+/* parse "k=v&k2=v2..." (n bytes) into t; a key without '=' gets an empty value */
+void form_parse(FormTable *t, Arena *a, const char *s, size_t n) {
+    memset(t, 0, sizeof(*t));
+    t->arena = a;
+    const char *end = s + n;
+    while (s < end) {
+        const char *amp = memchr(s, '&', (size_t)(end - s));
+        const char *pe = amp ? amp : end;
+        const char *eq = memchr(s, '=', (size_t)(pe - s));
+        if (pe > s) {
+            const char *kend = eq ? eq : pe;
+            char *key = form_decode(a, s, (size_t)(kend - s));
+            char *val = eq ? form_decode(a, eq + 1, (size_t)(pe - eq - 1)) : form_decode(a, "", 0);
+            if (key && val && key[0]) form_add(t, key, val);
+        }
+        s = pe + 1;
+    }
+}
+
+const FormField *form_field(const FormTable *t, const char *key) {
+    int idx = form_slot(t, key, core_str_hash(key));
+    return idx < 0 ? NULL : &t->fields[idx];
+}
+
+/* first value for key, or NULL */
+const char *form_get(const FormTable *t, const char *key) {
+    const FormField *f = form_field(t, key);
+    return f ? f->first->value : NULL;
+}
+
+/* ---------- Incremental HTTP/1.1 request parser ---------- */
+void http_parser_init(HttpParser *hp) {
+    memset(hp, 0, sizeof(*hp));
+    hp->content_length = -1;
+}
+
+static int span_eq_nocase(const char *buf, Span sp, const char *lit) {
+    size_t n = strlen(lit);
+    return sp.len == n && strncasecmp(buf + sp.off, lit, n) == 0;
+}
+
+static int http_fail(HttpParser *hp, int status) {
+    hp->status = status;
+    return HP_ERROR;
+}
+
+/* called once per completed header line: picks out the framing headers */
+static int http_header_done(HttpParser *hp, const char *buf) {
+    int i = hp->nheaders - 1;
+    Span v = hp->hvalue[i];
+    while (v.len > 0 && (buf[v.off + v.len - 1] == ' ' || buf[v.off + v.len - 1] == '\t')) v.len--;
+    hp->hvalue[i] = v;
+    if (span_eq_nocase(buf, hp->hname[i], "Content-Length")) {
+        long n = 0;
+        if (v.len == 0 || v.len > 10) return http_fail(hp, 400);
+        for (size_t k = 0; k < v.len; ++k) {
+            char c = buf[v.off + k];
+            if (c < '0' || c > '9') return http_fail(hp, 400);
+            n = n * 10 + (c - '0');
+        }
+        if (hp->content_length >= 0 && hp->content_length != n) return http_fail(hp, 400);
+        hp->content_length = n;
+    } else if (span_eq_nocase(buf, hp->hname[i], "Transfer-Encoding")) {
+        hp->chunked = 1;
+    }
+    return HP_NEED_MORE;
+}
+
+/* parse buf[hp->pos .. len); returns HP_COMPLETE, HP_NEED_MORE or HP_ERROR */
+int http_parse(HttpParser *hp, const char *buf, size_t len) {
+    size_t i = hp->pos;
+    for (; i < len; ++i) {
+        unsigned char c = (unsigned char)buf[i];
+        switch (hp->state) {
+        case HP_METHOD:
+            if (c == ' ') {
+                if (i == hp->tok) return http_fail(hp, 400);
+                hp->method = (Span){ hp->tok, i - hp->tok };
+                hp->tok = i + 1; hp->state = HP_TARGET;
+            } else if (!isupper(c) || i - hp->tok >= 16) return http_fail(hp, 400);
+            break;
+        case HP_TARGET:
+            if (c == ' ') {
+                if (i == hp->tok) return http_fail(hp, 400);
+                hp->target = (Span){ hp->tok, i - hp->tok };
+                hp->tok = i + 1; hp->state = HP_VERSION;
+            } else if (c <= ' ' || c == 0x7f) return http_fail(hp, 400);
+            break;
+        case HP_VERSION:
+            if (c == '\r' || c == '\n') {
+                hp->version = (Span){ hp->tok, i - hp->tok };
+                if (hp->version.len != 8 || strncmp(buf + hp->version.off, "HTTP/1.", 7) != 0)
+                    return http_fail(hp, 400);
+                hp->state = (c == '\r') ? HP_REQLINE_LF : HP_HEADER_START;
+            }
+            break;
+        case HP_REQLINE_LF:
+            if (c != '\n') return http_fail(hp, 400);
+            hp->state = HP_HEADER_START;
+            break;
+        case HP_HEADER_START:
+            if (c == '\r') { hp->state = HP_HEAD_END_LF; break; }
+            if (c == '\n') goto head_done;
+            if (c == ' ' || c == '\t' || c == ':') return http_fail(hp, 400);  /* no obs-fold */
+            if (hp->nheaders >= MAX_HEADERS) return http_fail(hp, 431);
+            hp->tok = i; hp->state = HP_HNAME;
+            break;
+        case HP_HNAME:
+            if (c == ':') {
+                hp->hname[hp->nheaders] = (Span){ hp->tok, i - hp->tok };
+                hp->state = HP_HVALUE_LWS;
+            } else if (c <= ' ' || c == 0x7f) return http_fail(hp, 400);
+            break;
+        case HP_HVALUE_LWS:
+            if (c == ' ' || c == '\t') break;
+            hp->tok = i; hp->state = HP_HVALUE;
+            /* fall through */
+        case HP_HVALUE:
+            if (c == '\r' || c == '\n') {
+                hp->hvalue[hp->nheaders++] = (Span){ hp->tok, i - hp->tok };
+                if (http_header_done(hp, buf) == HP_ERROR) return HP_ERROR;
+                hp->state = (c == '\r') ? HP_HVALUE_LF : HP_HEADER_START;
+            }
+            break;
+        case HP_HVALUE_LF:
+            if (c != '\n') return http_fail(hp, 400);
+            hp->state = HP_HEADER_START;
+            break;
+        case HP_HEAD_END_LF:
+            if (c != '\n') return http_fail(hp, 400);
+            goto head_done;
+        default:
+            return HP_COMPLETE;
+        }
+    }
+    hp->pos = i;
+    if (len >= HEAD_CAP) return http_fail(hp, 431);
+    return HP_NEED_MORE;
+
+head_done:
+    hp->pos = hp->head_len = i + 1;
+    hp->state = HP_DONE;
+    if (hp->head_len > HEAD_CAP) return http_fail(hp, 431);
+    if (hp->chunked) return http_fail(hp, 501);
+    if (hp->content_length > MAX_BODY) return http_fail(hp, 413);
+    return HP_COMPLETE;
+}
+
+static Slice span_slice(const char *buf, Span sp) { return (Slice){ buf + sp.off, sp.len }; }
+
+/* expose a completed parse as slices; path/query split on the first '?' */
+void http_request_from_parser(HttpRequest *r, const HttpParser *hp, const char *buf) {
+    memset(r, 0, sizeof(*r));
+    r->method = span_slice(buf, hp->method);
+    r->target = span_slice(buf, hp->target);
+    r->version = span_slice(buf, hp->version);
+    const char *q = memchr(r->target.p, '?', r->target.n);
+    r->path = r->target;
+    if (q) {
+        r->path.n = (size_t)(q - r->target.p);
+        r->query = (Slice){ q + 1, r->target.n - r->path.n - 1 };
+    }
+    r->nheaders = hp->nheaders;
+    for (int i = 0; i < hp->nheaders; ++i) {
+        r->hname[i] = span_slice(buf, hp->hname[i]);
+        r->hvalue[i] = span_slice(buf, hp->hvalue[i]);
+    }
+}
+
+/* case-insensitive header lookup; returns an empty slice when missing */
+Slice http_header(const HttpRequest *r, const char *name) {
+    size_t n = strlen(name);
+    for (int i = 0; i < r->nheaders; ++i)
+        if (r->hname[i].n == n && strncasecmp(r->hname[i].p, name, n) == 0) return r->hvalue[i];
+    return (Slice){ NULL, 0 };
+}
+
+int slice_eq(Slice s, const char *lit) {
+    size_t n = strlen(lit);
+    return s.n == n && memcmp(s.p, lit, n) == 0;
+}
+
+/* copy a slice into a fixed buffer as a C string (truncating) */
+void slice_copy(Slice s, char *out, size_t outcap) {
+    size_t n = s.n < outcap - 1 ? s.n : outcap - 1;
+    if (n) memcpy(out, s.p, n);
+    out[n] = 0;
+}
+
+/* ---------- Route trie ---------- */
+#define ROUTE_NODES 512
+
+typedef struct {
+    unsigned char ch;
+    short child, sibling;           /* -1 = none */
+    const Route *exact[M_COUNT];
+    const Route *prefix[M_COUNT];   /* pattern ended in '*' at this node */
+} RouteNode;
+
+static RouteNode route_nodes[ROUTE_NODES];
+static int route_node_count;
+
+static int route_child(int node, unsigned char ch) {
+    for (int c = route_nodes[node].child; c >= 0; c = route_nodes[c].sibling)
+        if (route_nodes[c].ch == ch) return c;
+    return -1;
+}
+
+int routes_init(const Route *routes, size_t n) {
+    memset(route_nodes, 0, sizeof(route_nodes));
+    route_nodes[0].child = route_nodes[0].sibling = -1;
+    route_node_count = 1;
+    for (size_t r = 0; r < n; ++r) {
+        const char *p = routes[r].pattern;
+        int node = 0, wildcard = 0;
+        for (; *p; ++p) {
+            if (*p == '*' && p[1] == 0) { wildcard = 1; break; }
+            int c = route_child(node, (unsigned char)*p);
+            if (c < 0) {
+                if (route_node_count >= ROUTE_NODES) return -1;
+                c = route_node_count++;
+                route_nodes[c].ch = (unsigned char)*p;
+                route_nodes[c].child = -1;
+                route_nodes[c].sibling = route_nodes[node].child;
+                route_nodes[node].child = (short)c;
+            }
+            node = c;
+        }
+        const Route **slots = wildcard ? route_nodes[node].prefix : route_nodes[node].exact;
+        for (int m = 0; m < M_COUNT; ++m)
+            if (routes[r].method == M_ANY || routes[r].method == m) slots[m] = &routes[r];
+    }
+    return 0;
+}
+
+static int route_has_any(const Route *const *slots) {
+    for (int m = 0; m < M_COUNT; ++m) if (slots[m]) return 1;
+    return 0;
+}
+
+const Route *const *route_match(const char *path, const char **param) {
+    /* walk the trie, remembering the deepest wildcard passed on the way */
+    int node = 0, wild = -1;
+    size_t i = 0, wild_at = 0;
+    for (;; ++i) {
+        if (route_has_any(route_nodes[node].prefix)) { wild = node; wild_at = i; }
+        if (!path[i]) break;
+        node = route_child(node, (unsigned char)path[i]);
+        if (node < 0) break;
+    }
+    *param = "";
+    if (node >= 0 && route_has_any(route_nodes[node].exact)) return route_nodes[node].exact;
+    if (wild < 0) return NULL;
+    *param = path + wild_at;
+    return route_nodes[wild].prefix;
+}
+
+/* ---------- Sessions ----------
+   A lookup is one slot read and a compare; the caller resolves the
+   student id. Slots are claimed round-robin with a CAS on their
+   generation, preferring free or expired ones; with none left, the
+   session that expires first (the least recently used) is replaced, never
+   an arbitrary live one. Readers check the generation on both sides of the
+   copy, seqlock style, and never lock. Sessions slide: one used in the
+   second half of its lifetime is extended. */
+static long long mono_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec;
+}
+
+static int hex_val(int ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    return -1;
+}
+
+/* a new session for this student id; writes the token (SESSION_TOKEN_LEN + 1) */
+int session_create(SessionTable *t, int student, char *token) {
+    unsigned char key[16];
+    if (getrandom(key, sizeof(key), 0) != (ssize_t)sizeof(key)) return -1;
+    long long now = mono_s();
+    for (int probe = 0; probe < SESSION_MAX + 8; ++probe) {
+        unsigned int i;
+        if (probe < SESSION_MAX) {
+            /* first lap: only free or expired slots, round-robin */
+            i = atomic_fetch_add(&t->hand, 1) % SESSION_MAX;
+            Session *ss = &t->slot[i];
+            if (ss->student && atomic_load(&ss->expires) > now) continue;
+        } else {
+            /* table full of live sessions: replace the one that expires
+               first, i.e. the least recently used */
+            i = 0;
+            for (unsigned int k = 1; k < SESSION_MAX; ++k)
+                if (atomic_load(&t->slot[k].expires) < atomic_load(&t->slot[i].expires)) i = k;
+        }
+        Session *ss = &t->slot[i];
+        unsigned int g = atomic_load(&ss->gen);
+        if (g & 1) continue;
+        if (!atomic_compare_exchange_strong(&ss->gen, &g, g + 1)) continue;
+        ss->student = student;
+        memcpy(ss->key, key, sizeof(key));
+        atomic_store(&ss->expires, now + SESSION_TTL_S);
+        atomic_store(&ss->gen, g + 2);
+        static const char hex[] = "0123456789abcdef";
+        snprintf(token, SESSION_TOKEN_LEN + 1, "%04x", i);
+        for (int k = 0; k < 16; ++k) {
+            token[4 + 2 * k] = hex[key[k] >> 4];
+            token[5 + 2 * k] = hex[key[k] & 15];
+        }
+        token[SESSION_TOKEN_LEN] = 0;
+        return 0;
+    }
+    return -1;
+}
+
+/* table slot of a live session, or -1; *student gets its student id */
+int session_find(SessionTable *t, const char *token, int *student) {
+    if (!token || strlen(token) != SESSION_TOKEN_LEN) return -1;
+    unsigned int i = 0;
+    unsigned char key[16];
+    for (int k = 0; k < 4; ++k) {
+        int v = hex_val(token[k]);
+        if (v < 0) return -1;
+        i = i * 16 + (unsigned int)v;
+    }
+    for (int k = 0; k < 16; ++k) {
+        int hi = hex_val(token[4 + 2 * k]), lo = hex_val(token[5 + 2 * k]);
+        if (hi < 0 || lo < 0) return -1;
+        key[k] = (unsigned char)(hi << 4 | lo);
+    }
+    if (i >= SESSION_MAX) return -1;
+    Session *ss = &t->slot[i];
+    unsigned int g = atomic_load(&ss->gen);
+    if (g & 1) return -1;
+    int sid = ss->student;
+    unsigned char diff = 0;
+    for (int k = 0; k < 16; ++k) diff |= (unsigned char)(ss->key[k] ^ key[k]);
+    long long exp = atomic_load(&ss->expires);
+    if (atomic_load(&ss->gen) != g || diff || sid <= 0) return -1;
+    long long now = mono_s();
+    if (exp <= now) return -1;
+    if (exp - now < SESSION_TTL_S / 2) atomic_store(&ss->expires, now + SESSION_TTL_S);
+    *student = sid;
+    return (int)i;
+}
+
+void session_end(SessionTable *t, const char *token) {
+    int sid;
+    int i = session_find(t, token, &sid);
+    if (i >= 0) atomic_store(&t->slot[i].expires, 0);
+}
+
+/* the sid cookie of a request, copied into tok (SESSION_TOKEN_LEN + 1) */
+const char *session_cookie(const HttpRequest *rq, char *tok) {
+    Slice ck = http_header(rq, "Cookie");
+    for (size_t i = 0; ck.p && i + 4 <= ck.n; ++i) {
+        if ((i == 0 || ck.p[i - 1] == ' ' || ck.p[i - 1] == ';') && memcmp(ck.p + i, "sid=", 4) == 0) {
+            size_t j = i + 4, n = 0;
+            while (j < ck.n && ck.p[j] != ';' && n < SESSION_TOKEN_LEN) tok[n++] = ck.p[j++];
+            tok[n] = 0;
+            return tok;
+        }
+    }
+    return NULL;
+}
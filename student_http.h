@@ -0,0 +1,194 @@
+/*
+  student_http.h
+  Student Record & Result Management System - HTTP plumbing of the web server
+
+  The parts of student_system_web.c that work on bytes and small tables
+  only, with no sockets, roster or shared store behind them, so they link
+  into the tests as they are: the request arena, form / query decoding,
+  the incremental HTTP/1.1 request parser, the route trie and the session
+  table (which lives wherever the caller puts it; the web server keeps it
+  in its shared Store).
+*/
+#ifndef STUDENT_HTTP_H
+#define STUDENT_HTTP_H
+
+#include <stddef.h>
+
+/* ---------- Request arena ----------
+   Bump allocator for request-scoped data. Each connection owns one; it is
+   reset after the response is sent, keeping its first block for the next
+   request. Allocations larger than ARENA_LARGE bypass the blocks and are
+   malloc'd individually, then released by the same reset. */
+#define ARENA_BLOCK (64 * 1024)
+#define ARENA_LARGE (ARENA_BLOCK / 4)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t cap;
+    char data[];
+} ArenaBlock;
+
+typedef struct ArenaLarge {
+    struct ArenaLarge *next;
+    size_t size;
+    size_t pad;                 /* keeps data 16-byte aligned */
+    char data[];
+} ArenaLarge;
+
+typedef struct {
+    ArenaBlock *head;           /* current block; older blocks follow */
+    ArenaLarge *large;
+    char *last;                 /* most recent bump allocation (for in-place growth) */
+} Arena;
+
+void *arena_alloc(Arena *a, size_t n);
+/* grow an allocation made from this arena, in place when it is the newest one */
+void *arena_grow(Arena *a, void *p, size_t oldn, size_t newn);
+/* drop everything but the oldest block, which is kept for reuse */
+void arena_reset(Arena *a);
+
+/* ---------- Form / query decoding ----------
+   application/x-www-form-urlencoded input is URL-decoded in one pass into a
+   small open-addressing table of key -> list of values (in input order).
+   Keys, values and table storage all come from the request arena. */
+typedef struct FormValue {
+    const char *value;
+    struct FormValue *next;
+} FormValue;
+
+typedef struct {
+    const char *key;
+    unsigned int hash;
+    FormValue *first;
+    FormValue *last;
+    int count;
+} FormField;
+
+typedef struct {
+    Arena *arena;
+    FormField *fields;      /* insertion order */
+    int nfields;
+    int cap;
+    int *slots;             /* index into fields, -1 = empty */
+    int nslots;             /* power of two, kept at least 2x cap */
+} FormTable;
+
+/* parse "k=v&k2=v2..." (n bytes) into t; a key without '=' gets an empty value */
+void form_parse(FormTable *t, Arena *a, const char *s, size_t n);
+const FormField *form_field(const FormTable *t, const char *key);
+/* first value for key, or NULL */
+const char *form_get(const FormTable *t, const char *key);
+
+/* ---------- Incremental HTTP/1.1 request parser ----------
+   The parser is fed the head buffer as bytes arrive and resumes where it left
+   off, so every byte is examined once. Tokens are recorded as offsets into the
+   buffer and exposed as slices once the head is complete. */
+#define HEAD_CAP (16 * 1024)          /* request line + headers; more is refused with 431 */
+#define MAX_BODY (8 * 1024 * 1024)    /* larger bodies are refused with 413 */
+#define MAX_HEADERS 64
+
+typedef struct { const char *p; size_t n; } Slice;
+typedef struct { size_t off, len; } Span;
+
+enum {
+    HP_METHOD, HP_TARGET, HP_VERSION, HP_REQLINE_LF,
+    HP_HEADER_START, HP_HNAME, HP_HVALUE_LWS, HP_HVALUE, HP_HVALUE_LF, HP_HEAD_END_LF,
+    HP_DONE
+};
+enum { HP_ERROR = -1, HP_NEED_MORE = 0, HP_COMPLETE = 1 };
+
+typedef struct {
+    int state;
+    size_t pos;                 /* bytes consumed so far */
+    size_t tok;                 /* start of the token being scanned */
+    Span method, target, version;
+    Span hname[MAX_HEADERS], hvalue[MAX_HEADERS];
+    int nheaders;
+    size_t head_len;            /* request line + headers + blank line */
+    long content_length;        /* -1 when absent */
+    int chunked;
+    int status;                 /* HTTP status to answer with on HP_ERROR */
+} HttpParser;
+
+typedef struct {
+    Slice method, target, path, query, version;
+    Slice hname[MAX_HEADERS], hvalue[MAX_HEADERS];
+    int nheaders;
+    const char *body;           /* NUL-terminated, body_len bytes */
+    size_t body_len;
+} HttpRequest;
+
+void http_parser_init(HttpParser *hp);
+/* parse buf[hp->pos .. len); returns HP_COMPLETE, HP_NEED_MORE or HP_ERROR */
+int http_parse(HttpParser *hp, const char *buf, size_t len);
+/* expose a completed parse as slices; path/query split on the first '?' */
+void http_request_from_parser(HttpRequest *r, const HttpParser *hp, const char *buf);
+/* case-insensitive header lookup; returns an empty slice when missing */
+Slice http_header(const HttpRequest *r, const char *name);
+int slice_eq(Slice s, const char *lit);
+/* copy a slice into a fixed buffer as a C string (truncating) */
+void slice_copy(Slice s, char *out, size_t outcap);
+
+/* ---------- Route trie ----------
+   Routes are compiled at startup into a byte trie keyed by path, with one
+   handler slot per method, so dispatch is a single walk over the path and
+   matches are exact: "/attendance" does not catch "/attendance-mark".
+   A pattern ending in '*' matches any remainder, which the handler gets as
+   param. */
+typedef struct {
+    int client;
+    Arena *arena;
+    const HttpRequest *rq;
+    const FormTable *form;
+    const char *method;
+    const char *path;
+    const char *param;              /* remainder matched by a trailing '*' */
+} RouteCtx;
+
+typedef void (*RouteFn)(const RouteCtx *rc);
+
+enum { M_GET, M_POST, M_OTHER, M_COUNT, M_ANY = -1 };
+
+typedef struct {
+    int method;
+    const char *pattern;
+    RouteFn fn;
+    int cost;                       /* the front end's, for admission control */
+} Route;
+
+/* build the trie from n routes (which must outlive it); -1 when it is full */
+int routes_init(const Route *routes, size_t n);
+/* the M_COUNT method slots of the route path falls to, or NULL: an exact
+   match first, else the deepest wildcard, whose remainder goes to *param */
+const Route *const *route_match(const char *path, const char **param);
+
+/* ---------- Sessions ----------
+   Signing in issues a random token held in a fixed session table, so
+   whichever worker gets the next request can resolve it. The token names
+   its table slot (4 hex digits) followed by 128 random bits. */
+#define SESSION_MAX 1024
+#define SESSION_TTL_S 1800
+#define SESSION_TOKEN_LEN (4 + 32)
+
+typedef struct {
+    _Atomic unsigned int gen;       /* odd while being rewritten */
+    int student;                    /* id, 0 = never used */
+    unsigned char key[16];
+    _Atomic long long expires;      /* CLOCK_MONOTONIC seconds */
+} Session;
+
+typedef struct {
+    _Atomic unsigned int hand;      /* next slot to try */
+    Session slot[SESSION_MAX];
+} SessionTable;
+
+/* a new session for this student id; writes the token (SESSION_TOKEN_LEN + 1) */
+int session_create(SessionTable *t, int student, char *token);
+/* table slot of a live session, or -1; *student gets its student id */
+int session_find(SessionTable *t, const char *token, int *student);
+void session_end(SessionTable *t, const char *token);
+/* the sid cookie of a request, copied into tok (SESSION_TOKEN_LEN + 1) */
+const char *session_cookie(const HttpRequest *rq, char *tok);
+
+#endif
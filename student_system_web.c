@@ -1,18 +1,20 @@
 /* student_system_web.c
-   Web wrapper for student_system.c
+   Web front end over the core data model (student_core.c)
    - Landing: Admin login / Student signup / Student signin
    - Student signup includes email, phone, semester (auto-adds semester subjects)
    - Admin: select semester -> choose subject(s) -> mark attendance
    - Admin: enter marks -> input student id -> auto-select current semester -> show semester subjects in a table and submit marks
    - Student dashboard: semester-bifurcated subjects (latest sem first), semester-wise attendance distribution, marks, SGPA, CGPA
+   - Every change goes through one queue to a single applier, which journals it to data/
 
    Build with:
-     gcc -DBUILD_WEB student_system.c student_system_web.c -o student_system_web
+     make student_system_web      (links student_http.o and libstudentcore.a)
 */
 
 #define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <strings.h>   // strcasestr
 #include <ctype.h>
@@ -22,61 +24,33 @@
 #include <limits.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/random.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <dirent.h>
 
+#include "student_core.h"
+#include "student_http.h"
+
 #ifndef PATH_MAX
 #define PATH_MAX 4096
 #endif
 
-/* --- Keep structs consistent with student_system.c --- */
-#define MAX_NAME 100
-#define MAX_SUBJECTS 64
-#define MAX_SUB_NAME 100
-
-typedef struct {
-    char name[MAX_SUB_NAME];
-    int classes_held;
-    int classes_attended;
-    int marks;
-    int credits;
-} Subject;
-
-typedef struct {
-    int id;
-    char name[MAX_NAME];
-    int age;
-    char email[120];
-    char phone[32];
-    char dept[MAX_NAME];
-    int year;
-    int current_semester;
-    int num_subjects;
-    Subject subjects[MAX_SUBJECTS];
-    char password[50];
-    int exists;
-    double cgpa;
-    int total_credits_completed;
-} Student;
-
-/* --- externs from student_system.c --- */
-/* globals */
-extern Student students[];
-extern int student_count;
-
-/* APIs */
-extern int api_find_index_by_id(int id);
-extern int api_add_student(Student *s);
-extern void api_generate_report(int idx, const char* college, const char* semester, const char* exam);
-extern int api_calculate_update_cgpa(int idx);
-extern int api_admin_auth(const char *user, const char *pass);
-
-/* helpers (implemented in student_system.c) */
-extern void save_data(void);
-extern void load_data(void);
-
 /* filesystem helper */
 static void ensure_reports_dir(void) {
     struct stat st;
@@ -85,87 +59,172 @@ static void ensure_reports_dir(void) {
     }
 }
 
-/* tiny url-decode inplace */
-static void urldecode_inplace(char *s) {
-    char *d = s;
-    while (*s) {
-        if (*s == '+') { *d++ = ' '; s++; }
-        else if (*s == '%' && isxdigit((unsigned char)s[1]) && isxdigit((unsigned char)s[2])) {
-            char hex[3] = { s[1], s[2], 0 };
-            *d++ = (char)strtol(hex, NULL, 16);
-            s += 3;
-        } else {
-            *d++ = *s++;
-        }
-    }
-    *d = 0;
-}
-
-/* parse application/x-www-form-urlencoded body for key (returns malloc'd string or NULL) */
-static char *form_value(const char *body, const char *key) {
-    size_t k = strlen(key);
-    const char *p = body;
-    while (*p) {
-        const char *eq = strchr(p, '=');
-        const char *amp = strchr(p, '&');
-        if (!eq) break;
-        size_t name_len = (amp ? (size_t)(eq - p) : (size_t)(eq - p));
-        if (name_len == k && strncmp(p, key, k) == 0) {
-            const char *val_start = eq + 1;
-            const char *val_end = amp ? amp : (p + strlen(p));
-            size_t vlen = val_end - val_start;
-            char *out = malloc(vlen + 1);
-            if (!out) return NULL;
-            memcpy(out, val_start, vlen);
-            out[vlen] = 0;
-            urldecode_inplace(out);
-            return out;
+/* growable output buffer (responses are built into one of these); when an
+   arena is attached the storage comes from it and is never freed directly */
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    int oom;        /* set once an allocation failed; further appends are dropped */
+    Arena *arena;
+} Buf;
+
+static int buf_reserve(Buf *b, size_t extra) {
+    if (b->oom) return -1;
+    if (b->len + extra + 1 <= b->cap) return 0;
+    size_t ncap = b->cap ? b->cap : 4096;
+    while (ncap < b->len + extra + 1) ncap *= 2;
+    char *nd = b->arena ? arena_grow(b->arena, b->data, b->cap, ncap) : realloc(b->data, ncap);
+    if (!nd) { b->oom = 1; return -1; }
+    b->data = nd; b->cap = ncap;
+    return 0;
+}
+
+static void buf_append(Buf *b, const char *s, size_t n) {
+    if (buf_reserve(b, n) < 0) return;
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = 0;
+}
+
+static void buf_puts(Buf *b, const char *s) { buf_append(b, s, strlen(s)); }
+
+static void buf_putc(Buf *b, char c) {
+    if (buf_reserve(b, 1) < 0) return;
+    b->data[b->len++] = c;
+    b->data[b->len] = 0;
+}
+
+static void buf_printf(Buf *b, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void buf_printf(Buf *b, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    char tmp[256];
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n < sizeof(tmp)) { buf_append(b, tmp, (size_t)n); return; }
+    if (buf_reserve(b, (size_t)n) < 0) return;
+    va_start(ap, fmt);
+    vsnprintf(b->data + b->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    b->len += (size_t)n;
+}
+
+static void buf_free(Buf *b) {
+    if (!b->arena) free(b->data);
+    b->data = NULL; b->len = b->cap = 0; b->oom = 0;
+}
+
+/* HTML-escaped append */
+static void buf_put_html(Buf *b, const char *s) {
+    const char *run = s;
+    for (; *s; ++s) {
+        const char *rep;
+        switch (*s) {
+            case '&': rep = "&amp;"; break;
+            case '<': rep = "&lt;"; break;
+            case '>': rep = "&gt;"; break;
+            case '"': rep = "&quot;"; break;
+            case '\'': rep = "&#39;"; break;
+            default: continue;
         }
-        if (!amp) break;
-        p = amp + 1;
+        buf_append(b, run, (size_t)(s - run));
+        buf_puts(b, rep);
+        run = s + 1;
     }
-    return NULL;
+    buf_append(b, run, (size_t)(s - run));
 }
 
-/* html escape small function */
-static void html_escape_buf(const char *in, char *out, size_t outcap) {
-    size_t j = 0;
-    for (size_t i = 0; in[i] && j + 7 < outcap; ++i) {
-        char c = in[i];
-        if (c == '&') { strcpy(out + j, "&amp;"); j += 5; }
-        else if (c == '<') { strcpy(out + j, "&lt;"); j += 4; }
-        else if (c == '>') { strcpy(out + j, "&gt;"); j += 4; }
-        else if (c == '"') { strcpy(out + j, "&quot;"); j += 6; }
-        else out[j++] = c;
-    }
-    out[j] = 0;
+/* finished page, or NULL if building it ran out of memory */
+static char *buf_finish(Buf *b) {
+    if (buf_reserve(b, 0) < 0) return NULL;
+    b->data[b->len] = 0;
+    return b->data;
 }
 
-/* quick grade mapping (same as student_system.c) */
-static int marks_to_grade_point_local(int marks) {
-    if (marks >= 90) return 10;
-    if (marks >= 80) return 9;
-    if (marks >= 70) return 8;
-    if (marks >= 60) return 7;
-    if (marks >= 50) return 6;
-    if (marks >= 40) return 5;
-    return 0;
+/* ---------- Streaming JSON writer ----------
+   Writes straight into a Buf; the writer only tracks whether a separator is
+   needed at each nesting level, so there is no intermediate document tree. */
+#define JSON_MAX_DEPTH 16
+
+typedef struct {
+    Buf *out;
+    int depth;
+    int after_key;
+    unsigned char has_items[JSON_MAX_DEPTH];
+} JsonWriter;
+
+static void json_init(JsonWriter *w, Buf *out) {
+    memset(w, 0, sizeof(*w));
+    w->out = out;
 }
 
-/* compute SGPA locally (per-semester or overall depending subjects passed) */
-static double compute_sgpa_local_for_subjects(Subject *subs, int n) {
-    int total_credits = 0;
-    double weighted = 0.0;
-    for (int i = 0; i < n; ++i) {
-        int cr = subs[i].credits;
-        int mk = subs[i].marks;
-        if (cr <= 0) continue;
-        int gp = marks_to_grade_point_local(mk);
-        weighted += (double)gp * cr;
-        total_credits += cr;
+/* emit ',' between siblings; a value directly after a key needs none */
+static void json_sep(JsonWriter *w) {
+    if (w->after_key) { w->after_key = 0; return; }
+    if (w->has_items[w->depth]) buf_putc(w->out, ',');
+    w->has_items[w->depth] = 1;
+}
+
+static void json_push(JsonWriter *w, char open) {
+    json_sep(w);
+    buf_putc(w->out, open);
+    if (w->depth + 1 < JSON_MAX_DEPTH) w->depth++;
+    w->has_items[w->depth] = 0;
+}
+
+static void json_pop(JsonWriter *w, char close_ch) {
+    buf_putc(w->out, close_ch);
+    if (w->depth > 0) w->depth--;
+}
+
+static void json_obj_begin(JsonWriter *w) { json_push(w, '{'); }
+static void json_obj_end(JsonWriter *w)   { json_pop(w, '}'); }
+static void json_arr_begin(JsonWriter *w) { json_push(w, '['); }
+static void json_arr_end(JsonWriter *w)   { json_pop(w, ']'); }
+
+static void json_write_escaped(Buf *b, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    buf_putc(b, '"');
+    const char *run = s;
+    for (; *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        buf_append(b, run, (size_t)(s - run));
+        run = s + 1;
+        switch (c) {
+            case '"':  buf_puts(b, "\\\""); break;
+            case '\\': buf_puts(b, "\\\\"); break;
+            case '\n': buf_puts(b, "\\n"); break;
+            case '\r': buf_puts(b, "\\r"); break;
+            case '\t': buf_puts(b, "\\t"); break;
+            default: {
+                char u[7] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15], 0 };
+                buf_append(b, u, 6);
+            }
+        }
     }
-    if (total_credits == 0) return 0.0;
-    return weighted / (double)total_credits;
+    buf_append(b, run, (size_t)(s - run));
+    buf_putc(b, '"');
+}
+
+static void json_key(JsonWriter *w, const char *k) {
+    json_sep(w);
+    json_write_escaped(w->out, k);
+    buf_putc(w->out, ':');
+    w->after_key = 1;
+}
+
+static void json_str(JsonWriter *w, const char *s) { json_sep(w); json_write_escaped(w->out, s ? s : ""); }
+static void json_int(JsonWriter *w, long v) { json_sep(w); buf_printf(w->out, "%ld", v); }
+static void json_null(JsonWriter *w) { json_sep(w); buf_puts(w->out, "null"); }
+
+/* fixed 3-decimal output matches what the HTML pages show */
+static void json_num(JsonWriter *w, double v) {
+    json_sep(w);
+    if (v != v) { buf_puts(w->out, "null"); return; }
+    buf_printf(w->out, "%.3f", v);
 }
 
 /* helper to slugify subject for filename */
@@ -182,91 +241,1447 @@ static void slugify(const char *in, char *out, size_t outcap) {
     out[j]=0;
 }
 
+/* ---------- Roster store ----------
+   The roster the pages read and write is a flat Dataset, the core CoreDb:
+   fixed-size tables and counts only, no pointers, so the same bytes are
+   valid at any address.
+   The Store holds several versions of it and an index saying which one is
+   current. In worker mode (WORKERS=N) the master maps the Store from a
+   memfd before forking and every worker serves straight out of that shared
+   mapping; otherwise it is a private mapping of the same layout.
+
+   Versions are multi-version snapshots. A reader never locks: it pins the
+   current version in its pinner entry (one per serving process, plus the
+   reload thread and the job threads) and re-checks that it is still
+   current. Whatever it then reads stays consistent however long it takes,
+   since versions are never written while pinned. Writers (the mutation
+   applier below, and reloads from data/) serialize on a process-shared
+   robust mutex, build the next version in a slot that is neither current
+   nor pinned, and publish it by swapping the index, RCU style. Old versions are reclaimed
+   as soon as no pin references them. Each pinner holds at most one pin,
+   so with pinners + 2 slots there is always a free one: a long read
+   (an export, a report, a reload parsing data/) never holds up a writer,
+   and a writer never waits for readers. A worker that dies mid-request
+   has its pin cleared by the master. */
+typedef CoreDb Dataset;              /* version = store version it was published as */
+
+#define STORE_WORKERS_MAX 64
+#define JOB_THREADS 2               /* see Jobs below */
+#define PIN_SERVER 0                /* the serving process without WORKERS */
+#define PIN_RELOAD 1                /* the data/ watcher thread */
+#define PIN_APPLIER 2               /* the mutation applier, while it checkpoints */
+#define PIN_JOB0 3                  /* job thread i is PIN_JOB0 + i */
+#define PIN_WORKER0 (PIN_JOB0 + JOB_THREADS)    /* worker i is PIN_WORKER0 + i */
+#define STORE_PINNERS (PIN_WORKER0 + STORE_WORKERS_MAX)
+#define STORE_VERSIONS_MAX (STORE_WORKERS_MAX + JOB_THREADS + 4)
+
+/* identity of a data/ file as the server last wrote it, so the watcher can
+   tell its own saves from files dropped in by someone else */
+typedef struct {
+    unsigned long long ino, size;
+    long long mtime_ns;
+} FileStamp;
+
+/* one change-feed event; seq is 0 while the slot is being rewritten */
+#define FEED_RING 64
+#define FEED_DATA_MAX 240
+
+typedef struct {
+    _Atomic unsigned long long seq;
+    int student, semester;          /* who it concerns, 0 = everyone */
+    char type[16];
+    char data[FEED_DATA_MAX];       /* one line of JSON */
+} FeedEvent;
+
+/* one queued change; see Mutation queue below */
+#define MUT_RING 1024               /* power of two */
+#define MUT_BATCH 64                /* commands applied per published version */
+#define MUT_SUBJECTS 12             /* subjects one command names */
+#define MUT_STUDENTS 64             /* students one attendance command marks */
+
+enum { MUT_REGISTER = 1, MUT_MARKS, MUT_ATTENDANCE, MUT_RECOMPUTE };
+
+typedef struct {
+    _Atomic unsigned long long seq; /* ring position the slot is free for (pos) or ready at (pos + 1) */
+    unsigned char op;               /* MUT_* */
+    unsigned char pinner;           /* whose reply it is */
+    unsigned char nsubjects, nstudents;
+    unsigned int ticket;
+    unsigned long long present;     /* MUT_ATTENDANCE: bit i = students[i] was there */
+    char subjects[MUT_SUBJECTS][MAX_SUBID];     /* subject ids */
+    union {
+        Student reg;                            /* MUT_REGISTER */
+        struct { int student; short marks[MUT_SUBJECTS]; } m;  /* MUT_MARKS */
+        int students[MUT_STUDENTS];             /* MUT_ATTENDANCE: ids */
+    } u;
+    FeedEvent event;                /* posted with the change; type "" = none */
+} Mutation;
+
+#define MUT_RESULTS 8192            /* power of two; see Parked writes */
+
+typedef struct {
+    _Atomic unsigned int done;      /* last ticket applied; a futex word */
+    int result[MUT_RESULTS];        /* ticket t's result at t % MUT_RESULTS */
+} MutReply;
+
+/* a background job; see Jobs below */
+#define JOB_MAX 64
+
+enum { JOB_QUEUED, JOB_RUNNING, JOB_DONE, JOB_FAILED, JOB_CANCELLED };
+enum { JOB_HIGH, JOB_NORMAL, JOB_LOW, JOB_PRIORITIES };
+
+typedef struct {
+    unsigned int id;                /* 0 = never used */
+    unsigned char kind;             /* index into JOB_KINDS */
+    unsigned char priority;         /* JOB_HIGH .. JOB_LOW */
+    unsigned char state;            /* JOB_QUEUED ..; under job_lock */
+    int semester;                   /* parameter of the kinds that take one */
+    _Atomic int cancel;             /* asked to stop while running */
+    _Atomic int done, total;        /* progress, in students */
+    long long created, started, finished;   /* unix seconds, 0 = not yet */
+    char artifact[96];              /* file under JOB_DIR once done */
+    char error[64];
+} Job;
+
+typedef struct {
+    pthread_mutex_t write_lock;     /* process-shared, robust */
+    _Atomic int current;            /* slot readers enter */
+    _Atomic int pins[STORE_PINNERS];    /* slot each pinner reads, -1 = none */
+    int versions;                   /* slots in slot[] */
+    unsigned long long version;     /* last published; under write_lock */
+    FileStamp written[CORE_FILES];
+    _Atomic unsigned long long feed_seq;    /* last event published */
+    FeedEvent feed[FEED_RING];
+    SessionTable sessions;          /* signed-in students (student_http.c) */
+    _Atomic unsigned long long mut_head;    /* next ring position to claim */
+    _Atomic unsigned int mut_wake;          /* bumped per push; the applier's futex word */
+    MutReply replies[STORE_PINNERS];
+    Mutation mut[MUT_RING];
+    pthread_mutex_t job_lock;       /* process-shared, robust; guards jobs[] states */
+    _Atomic unsigned int job_wake;  /* bumped per submit; the job threads' futex word */
+    unsigned int job_next;          /* last job id handed out */
+    Job jobs[JOB_MAX];
+    Dataset slot[];
+} Store;
+
+static Store *store;
+static Dataset *db;                 /* dataset the running request sees */
+static _Thread_local int pin_self = PIN_SERVER;    /* this thread's pinner entry */
+static int feed_staged;             /* events posted by the running write */
+static int mut_efd[STORE_PINNERS];  /* eventfd the applier signals, per serving pinner; -1 = none */
+
+static void data_saved(int file);
+static void data_rejected(const char *file, int line, const char *row, const char *why);
+static unsigned int data_changed_externally(void);
+static void data_stamp_all(void);
+
+/* workers: serving processes (0 = this one serves alone) */
+static int store_init(int workers) {
+    int shared = workers > 0;
+    int versions = (shared ? workers : 1) + 2 + JOB_THREADS + 2;  /* pinners + current + next */
+    size_t size = sizeof(Store) + (size_t)versions * sizeof(Dataset);
+    void *p;
+    if (shared) {
+        int fd = memfd_create("student-store", MFD_CLOEXEC);
+        if (fd < 0 || ftruncate(fd, (off_t)size) < 0) { perror("memfd"); return -1; }
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);                  /* the mapping keeps it alive across fork */
+    } else {
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (p == MAP_FAILED) { perror("mmap"); return -1; }
+    store = p;
+    store->versions = versions;
+    for (int i = 0; i < STORE_PINNERS; ++i) atomic_store(&store->pins[i], -1);
+    for (int i = 0; i < MUT_RING; ++i) atomic_store(&store->mut[i].seq, (unsigned long long)i);
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, shared ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&store->write_lock, &attr);
+    pthread_mutex_init(&store->job_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    /* made before forking, so each worker inherits its own */
+    for (int i = 0; i < STORE_PINNERS; ++i) mut_efd[i] = -1;
+    for (int i = 0; i < (shared ? workers : 1); ++i) {
+        int p = shared ? PIN_WORKER0 + i : PIN_SERVER;
+        if ((mut_efd[p] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) { perror("eventfd"); return -1; }
+    }
+    data_stamp_all();
+    core_load(&store->slot[0], NULL, data_rejected);
+    store->version = store->slot[0].version = 1;
+    store->slot[0].subjects_version = 1;
+    return 0;
+}
+
+/* pin the current version as pinner's snapshot */
+static Dataset *store_enter(int pinner) {
+    for (;;) {
+        int s = atomic_load(&store->current);
+        atomic_store(&store->pins[pinner], s);
+        if (atomic_load(&store->current) == s) return &store->slot[s];
+    }
+}
+
+static void store_exit(int pinner) {
+    atomic_store(&store->pins[pinner], -1);
+}
+
+/* the oldest slot that is neither current nor pinned, or -1 */
+static int store_free_slot(void) {
+    unsigned char pinned[STORE_VERSIONS_MAX] = {0};
+    for (int i = 0; i < STORE_PINNERS; ++i) {
+        int s = atomic_load(&store->pins[i]);
+        if (s >= 0) pinned[s] = 1;
+    }
+    int cur = atomic_load(&store->current), best = -1;
+    for (int s = 0; s < store->versions; ++s) {
+        if (s == cur || pinned[s]) continue;
+        if (best < 0 || store->slot[s].version < store->slot[best].version) best = s;
+    }
+    return best;
+}
+
+/* take the writer lock and a free slot to build the next version in. One
+   always exists unless a dead worker's pin has not been cleared yet, which
+   the master does as it reaps it. */
+static int store_lock_spare(void) {
+    if (pthread_mutex_lock(&store->write_lock) == EOWNERDEAD)
+        pthread_mutex_consistent(&store->write_lock);
+    int spare;
+    while ((spare = store_free_slot()) < 0) usleep(1000);
+    return spare;
+}
+
+/* make the spare slot current (caller holds the writer lock) */
+static void store_publish(int spare) {
+    store->slot[spare].version = ++store->version;
+    atomic_store(&store->current, spare);
+}
+
+/* Change feed: writers post events into the ring under the writer lock;
+   they become visible to the event streams (feed_pump) when the write is
+   published. */
+static void feed_post(const char *type, int student, int semester, const char *data) {
+    if (feed_staged >= FEED_RING / 2) return;
+    unsigned long long seq = atomic_load(&store->feed_seq) + 1 + (unsigned long long)feed_staged++;
+    FeedEvent *e = &store->feed[seq % FEED_RING];
+    atomic_store(&e->seq, 0);
+    e->student = student;
+    e->semester = semester;
+    snprintf(e->type, sizeof(e->type), "%s", type);
+    snprintf(e->data, sizeof(e->data), "%s", data);
+    atomic_store(&e->seq, seq);
+}
+
+static void feed_commit(int publish) {
+    if (publish && feed_staged) atomic_fetch_add(&store->feed_seq, (unsigned long long)feed_staged);
+    feed_staged = 0;
+}
+
+/* copy out event seq; 0 if the ring has already moved past it */
+static int feed_read(unsigned long long seq, FeedEvent *out) {
+    const FeedEvent *e = &store->feed[seq % FEED_RING];
+    if (atomic_load(&e->seq) != seq) return 0;
+    out->student = e->student;
+    out->semester = e->semester;
+    memcpy(out->type, e->type, sizeof(out->type));
+    memcpy(out->data, e->data, sizeof(out->data));
+    out->type[sizeof(out->type) - 1] = 0;
+    out->data[sizeof(out->data) - 1] = 0;
+    return atomic_load(&e->seq) == seq;
+}
+
+/* ---------- Mutation queue ----------
+   Requests never change the roster themselves. They read their snapshot
+   like any other request, describe the change as compact Mutation records
+   (register a student, set marks, mark attendance for up to MUT_STUDENTS
+   students, re-derive every CGPA) and push them into a bounded multi-producer ring in the
+   Store, Vyukov style: a producer claims a position with a CAS on the
+   head, fills the slot and releases it by bumping its seq; there is no
+   lock on the way in, and a full ring only makes producers wait for room.
+
+   One applier thread (in the master under WORKERS=N) drains the ring in
+   batches of up to MUT_BATCH: one copy of the current version, every
+   command of the batch applied to it, one publish. Each change is also
+   appended to the core journal (data/journal.log) as a post-image before
+   the version is published, so the command stream is the write-ahead log
+   and the CSV files only need rewriting at checkpoints, when the journal
+   has grown long or the queue has gone idle. The applier then posts each
+   command's result to its pinner's reply slot and wakes the producer: a
+   job thread sleeps on the slot's futex, a serving process is signalled
+   through its eventfd and finishes the request from its event loop (see
+   mut_reply_later). A producer that dies between claiming a slot and
+   releasing it stalls the applier; the window is a memcpy long. */
+#define JOURNAL_CHECKPOINT_LINES 20000
+#define JOURNAL_IDLE_MS 1000
+
+static _Thread_local unsigned int mut_ticket;   /* last ticket this thread pushed */
+
+static void futex_wait(_Atomic unsigned int *word, unsigned int val, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, val, timeout_ms >= 0 ? &ts : NULL, NULL, 0);
+}
+
+static void futex_wake(_Atomic unsigned int *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/* start a request's changes: the ticket its first push will get */
+static unsigned int mut_begin(void) {
+    return mut_ticket + 1;
+}
+
+/* queue a copy of cmd; its ticket */
+static unsigned int mut_push(const Mutation *cmd) {
+    Mutation *m;
+    unsigned long long pos;
+    for (;;) {
+        pos = atomic_load(&store->mut_head);
+        m = &store->mut[pos & (MUT_RING - 1)];
+        unsigned long long seq = atomic_load(&m->seq);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak(&store->mut_head, &pos, pos + 1)) break;
+        } else if (seq < pos) {
+            usleep(100);            /* full: the applier is a lap behind */
+        }
+    }
+    memcpy(&m->op, &cmd->op, sizeof(Mutation) - offsetof(Mutation, op));
+    m->pinner = (unsigned char)pin_self;
+    m->ticket = ++mut_ticket;
+    atomic_store(&m->seq, pos + 1);
+    atomic_fetch_add(&store->mut_wake, 1);
+    futex_wake(&store->mut_wake);
+    return mut_ticket;
+}
+
+/* whether this thread's tickets up to last are applied and published */
+static int mut_done(unsigned int last) {
+    return (int)(atomic_load(&store->replies[pin_self].done) - last) >= 0;
+}
+
+/* the results of this thread's tickets first..last, summed (all done) */
+static int mut_sum(unsigned int first, unsigned int last) {
+    const MutReply *r = &store->replies[pin_self];
+    int sum = 0;
+    for (unsigned int t = first; (int)(last - t) >= 0; ++t) sum += r->result[t & (MUT_RESULTS - 1)];
+    return sum;
+}
+
+/* sleep until tickets first..last are done; their results summed. For job
+   threads: a serving process parks the request instead (mut_reply_later). */
+static int mut_wait(unsigned int first, unsigned int last) {
+    MutReply *r = &store->replies[pin_self];
+    for (;;) {
+        unsigned int done = atomic_load(&r->done);
+        if ((int)(done - last) >= 0) return mut_sum(first, last);
+        futex_wait(&r->done, done, 1000);
+    }
+}
+
+/* ---- applier side ---- */
+static unsigned long long mut_tail;     /* next ring position to apply */
+static CoreIndex mut_ix;
+static FILE *journal;
+static _Atomic long journal_lines;
+/* held while data/ is written by a checkpoint or read by a reload, so
+   neither sees the other's files half done */
+static pthread_mutex_t data_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void journal_put(const char *line, int len) {
+    if (!len) return;
+    if (!journal) {
+        mkdir(DATA_DIR, 0755);
+        journal = fopen(DATA_DIR "/" CORE_JOURNAL, "a");
+        if (!journal) { perror("journal"); return; }
+        int dir = open(DATA_DIR, O_RDONLY | O_DIRECTORY);   /* the new name must last too */
+        if (dir >= 0) { fsync(dir); close(dir); }
+    }
+    fwrite(line, 1, (size_t)len, journal);
+    journal_lines++;
+}
+
+static int mut_subject_row(const Dataset *d, const char *id) {
+    for (int i = 0; i < d->subject_count; ++i) if (strcmp(d->subjects[i].id, id) == 0) return i;
+    return -1;
+}
+
+/* result: the new student's id, -2 if the id is taken, -1 if full */
+static int mut_register(Dataset *d, const Mutation *m) {
+    int slot = core_add_student(d, &m->u.reg);
+    if (slot < 0) return slot;
+    core_enroll_upto(d, slot, d->students[slot].current_semester);
+    char line[512];
+    journal_put(line, core_journal_student(d, slot, line, sizeof(line)));
+    return m->u.reg.id;
+}
+
+/* result: enrollments whose marks were set */
+static int mut_marks(Dataset *d, const Mutation *m) {
+    core_index_refresh(&mut_ix, d);
+    int slot = core_student_slot(&mut_ix, d, m->u.m.student), n = 0;
+    if (slot < 0) return 0;
+    char line[128];
+    for (int k = 0; k < m->nsubjects; ++k) {
+        int row = mut_subject_row(d, m->subjects[k]);
+        Enrollment *e = row >= 0 ? core_enrollment(d, slot, row) : NULL;
+        if (!e) continue;
+        e->marks = m->u.m.marks[k];
+        journal_put(line, core_journal_enrollment(d, slot, e, line, sizeof(line)));
+        n++;
+    }
+    core_update_cgpa(d, slot);
+    return n;
+}
+
+/* result: enrollments that had a class added */
+static int mut_attendance(Dataset *d, const Mutation *m) {
+    core_index_refresh(&mut_ix, d);
+    int rows[MUT_SUBJECTS], n = 0;
+    for (int k = 0; k < m->nsubjects; ++k) rows[k] = mut_subject_row(d, m->subjects[k]);
+    char line[128];
+    for (int i = 0; i < m->nstudents; ++i) {
+        int slot = core_student_slot(&mut_ix, d, m->u.students[i]);
+        if (slot < 0) continue;
+        int was_present = (int)((m->present >> i) & 1);
+        for (int k = 0; k < m->nsubjects; ++k) {
+            Enrollment *e = rows[k] >= 0 ? core_enrollment(d, slot, rows[k]) : NULL;
+            if (!e || e->held == USHRT_MAX) continue;
+            e->held += 1;
+            if (was_present) e->attended += 1;
+            journal_put(line, core_journal_enrollment(d, slot, e, line, sizeof(line)));
+            n++;
+        }
+    }
+    return n;
+}
+
+/* result: students whose stored CGPA changed. The CGPA is derived, never
+   written to data/ (a load computes it again), so nothing is journaled. */
+static int mut_recompute(Dataset *d) {
+    int n = 0;
+    for (int i = 0; i < d->count; ++i) {
+        if (!d->students[i].exists) continue;
+        float was = d->students[i].cgpa;
+        core_update_cgpa(d, i);
+        n += d->students[i].cgpa != was;
+    }
+    return n;
+}
+
+static int mut_ready(void) {
+    return atomic_load(&store->mut[mut_tail & (MUT_RING - 1)].seq) == mut_tail + 1;
+}
+
+/* remove the journal once what it holds is in the files (caller holds the
+   writer lock and data_lock) */
+static void journal_drop(void) {
+    if (journal) { fclose(journal); journal = NULL; }
+    unlink(DATA_DIR "/" CORE_JOURNAL);
+    journal_lines = 0;
+}
+
+/* fold the journal into the CSV files (core_save removes it). The save
+   works from a pinned snapshot, outside the writer lock, so requests keep
+   publishing; nothing is applied meanwhile (this is the applier), so the
+   snapshot holds every journaled line. Files someone else dropped in are
+   left for the reload, not overwritten, and a reload under way means the
+   checkpoint waits for the next idle spell. */
+static void mut_checkpoint(void) {
+    if (pthread_mutex_trylock(&data_lock) != 0) return;
+    if (!data_changed_externally()) {
+        if (journal) { fclose(journal); journal = NULL; }
+        core_save(store_enter(PIN_APPLIER), data_saved);
+        store_exit(PIN_APPLIER);
+        journal_lines = 0;
+    }
+    pthread_mutex_unlock(&data_lock);
+}
+
+/* apply one batch as one new version, then reply */
+static void mut_apply_batch(void) {
+    static int results[MUT_BATCH];
+    int spare = store_lock_spare();
+    Dataset *d = &store->slot[spare];
+    core_copy(d, &store->slot[atomic_load(&store->current)]);
+    unsigned long long first = mut_tail;
+    long lines = journal_lines;
+    int n = 0;
+    for (; n < MUT_BATCH && mut_ready(); ++n, ++mut_tail) {
+        const Mutation *m = &store->mut[mut_tail & (MUT_RING - 1)];
+        results[n] = m->op == MUT_REGISTER ? mut_register(d, m)
+                   : m->op == MUT_MARKS ? mut_marks(d, m)
+                   : m->op == MUT_ATTENDANCE ? mut_attendance(d, m)
+                   : m->op == MUT_RECOMPUTE ? mut_recompute(d) : 0;
+        if (m->event.type[0]) feed_post(m->event.type, m->event.student, m->event.semester, m->event.data);
+    }
+    /* the batch is on disk before anyone can see it or is told it is done */
+    if (journal && journal_lines != lines && (fflush(journal) != 0 || fsync(fileno(journal)) != 0))
+        perror("journal");
+    store_publish(spare);
+    feed_commit(1);
+    pthread_mutex_unlock(&store->write_lock);
+
+    unsigned char woken[STORE_PINNERS] = {0};
+    for (int i = 0; i < n; ++i) {
+        Mutation *m = &store->mut[(first + (unsigned long long)i) & (MUT_RING - 1)];
+        MutReply *r = &store->replies[m->pinner];
+        r->result[m->ticket & (MUT_RESULTS - 1)] = results[i];
+        atomic_store(&r->done, m->ticket);
+        woken[m->pinner] = 1;
+        atomic_store(&m->seq, first + (unsigned long long)i + MUT_RING);
+    }
+    static const unsigned long long one = 1;
+    for (int p = 0; p < STORE_PINNERS; ++p) {
+        if (!woken[p]) continue;
+        if (mut_efd[p] < 0) futex_wake(&store->replies[p].done);
+        else if (write(mut_efd[p], &one, sizeof(one)) < 0 && errno != EAGAIN) perror("eventfd");
+    }
+}
+
+static void *mut_applier_main(void *arg) {
+    (void)arg;
+    /* a journal left by a crash was replayed at load; fold it in when idle */
+    if (access(DATA_DIR "/" CORE_JOURNAL, F_OK) == 0) journal_lines = 1;
+    for (;;) {
+        unsigned int wake = atomic_load(&store->mut_wake);
+        if (mut_ready()) {
+            mut_apply_batch();
+            if (journal_lines >= JOURNAL_CHECKPOINT_LINES) mut_checkpoint();
+            continue;
+        }
+        futex_wait(&store->mut_wake, wake, journal_lines ? JOURNAL_IDLE_MS : -1);
+        if (!mut_ready() && journal_lines && atomic_load(&store->mut_wake) == wake) mut_checkpoint();
+    }
+    return NULL;
+}
+
+static void mut_applier_start(void) {
+    pthread_t t;
+    if (pthread_create(&t, NULL, mut_applier_main, NULL) == 0) pthread_detach(t);
+}
+
+/* ---------- Data files ----------
+   The roster is kept in data/ in the core's CSV formats (student_core.c),
+   which are the console program's plus accounts.csv for password, age and
+   department. Each file is rewritten whole through a temporary and rename,
+   so a reader of data/ never sees half a file; the stamps below let the
+   watcher tell the server's own saves from files dropped in by someone
+   else. */
+static FileStamp file_stamp(const char *name) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), DATA_DIR "/%s", name);
+    struct stat st;
+    FileStamp fs = {0};
+    if (stat(path, &st) == 0) {
+        fs.ino = (unsigned long long)st.st_ino;
+        fs.size = (unsigned long long)st.st_size;
+        fs.mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    }
+    return fs;
+}
+
+/* remember data/ as it is about to be loaded, so only later changes count */
+static void data_stamp_all(void) {
+    for (int i = 0; i < CORE_FILES; ++i) store->written[i] = file_stamp(core_file_names[i]);
+}
+
+/* core_load callback: a row of data/ that was left out */
+static void data_rejected(const char *file, int line, const char *row, const char *why) {
+    fprintf(stderr, DATA_DIR "/%s:%d: %s; row not loaded: %s\n", file, line, why, row);
+}
+
+/* core_save callback: a file the server just wrote (under data_lock) */
+static void data_saved(int file) {
+    store->written[file] = file_stamp(core_file_names[file]);
+}
+
+/* ---------- Live reload ----------
+   A background thread watches data/ with inotify. Once changes to its CSV
+   files settle, and unless they are the server's own saves, it builds a
+   fresh dataset off to the side and publishes it like any other write:
+   readers carry on against the old slot and are never blocked. A file that
+   was replaced wins over what the server had for it; writes journaled but
+   not yet checkpointed are kept in the files that were not. */
+#define RELOAD_SETTLE_MS 200
+
+/* the data/ files not as the server last loaded or wrote them, as bits
+   1 << CORE_* */
+static unsigned int data_changed_externally(void) {
+    unsigned int changed = 0;
+    for (int i = 0; i < CORE_FILES; ++i) {
+        FileStamp now = file_stamp(core_file_names[i]), was = store->written[i];
+        if (now.ino != was.ino || now.size != was.size || now.mtime_ns != was.mtime_ns) changed |= 1u << i;
+    }
+    return changed;
+}
+
+static void data_reload(Dataset *fresh) {
+    pthread_mutex_lock(&data_lock);
+    /* what looked foreign may have been a checkpoint still being written */
+    unsigned int replaced = data_changed_externally();
+    if (!replaced) { pthread_mutex_unlock(&data_lock); return; }
+    /* The journal holds acknowledged writes the files do not have yet, but
+       replayed over the new files it would undo the corrections they bring.
+       So checkpoint the current version into the files that were not
+       replaced and drop it; writes queue meanwhile, as they do behind a
+       checkpoint. What is journaled from here on is kept like any write
+       that lands while parsing. */
+    if (pthread_mutex_lock(&store->write_lock) == EOWNERDEAD)
+        pthread_mutex_consistent(&store->write_lock);
+    if (journal_lines) {
+        if (core_save_files(&store->slot[atomic_load(&store->current)], CORE_ALL_FILES & ~replaced, data_saved) == 0)
+            journal_drop();
+        else
+            fprintf(stderr, "reload: cannot checkpoint " DATA_DIR "/, replaying the journal over it\n");
+    }
+    pthread_mutex_unlock(&store->write_lock);
+
+    const Dataset *cur = store_enter(PIN_RELOAD);
+    unsigned long long seen = cur->version;
+    data_stamp_all();
+    int rc = core_load(fresh, cur, data_rejected);
+    store_exit(PIN_RELOAD);
+    if (rc < 0) { pthread_mutex_unlock(&data_lock); return; }
+
+    int spare = store_lock_spare();
+    cur = &store->slot[atomic_load(&store->current)];
+    /* a write landed while parsing: parse again under the lock so it is kept
+       (rows it leaves out were reported the first time) */
+    if (cur->version != seen) {
+        data_stamp_all();
+        if (core_load(fresh, cur, NULL) < 0) {
+            pthread_mutex_unlock(&store->write_lock);
+            pthread_mutex_unlock(&data_lock);
+            return;
+        }
+    }
+    /* only a reload replaces the subject table; writes copy it along */
+    fresh->subjects_version = store->version + 1;
+    core_copy(&store->slot[spare], fresh);
+    store_publish(spare);
+    char ev[64];
+    snprintf(ev, sizeof(ev), "{\"version\":%llu,\"students\":%d}", store->version, fresh->count);
+    feed_post("reload", 0, 0, ev);
+    feed_commit(1);
+    pthread_mutex_unlock(&store->write_lock);
+    pthread_mutex_unlock(&data_lock);
+    fprintf(stderr, "reloaded %d students from " DATA_DIR "/ (version %llu)\n", fresh->count, store->version);
+}
+
+static void *data_watch_main(void *arg) {
+    (void)arg;
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, DATA_DIR, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE) < 0) {
+        perror("inotify");
+        return NULL;
+    }
+    Dataset *fresh = NULL;
+    char ev[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        if (read(fd, ev, sizeof(ev)) <= 0) { if (errno == EINTR) continue; break; }
+        /* let a burst of writes (several files copied in) settle first */
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        while (poll(&pfd, 1, RELOAD_SETTLE_MS) > 0) if (read(fd, ev, sizeof(ev)) <= 0) break;
+        if (!data_changed_externally()) continue;
+        if (!fresh && !(fresh = calloc(1, sizeof(Dataset)))) continue;
+        data_reload(fresh);
+    }
+    close(fd);
+    free(fresh);
+    return NULL;
+}
+
+static void data_watch_start(void) {
+    pthread_t t;
+    mkdir(DATA_DIR, 0755);
+    if (pthread_create(&t, NULL, data_watch_main, NULL) == 0) pthread_detach(t);
+}
+
+/* ---------- Jobs ----------
+   Work too long for a request (roster exports, result sheets, recomputing
+   every CGPA) runs as a job on a fixed pool of JOB_THREADS threads in the
+   master, so at most that many run at once however many are asked for. The
+   job table lives in the Store, so any worker can queue a job or report on
+   one. A job thread takes the queued job of highest priority, oldest
+   first, pins the current version like any reader, and writes its artifact
+   under JOB_DIR through a temporary and rename. Artifacts hold every
+   student's contact details, so they never go near the public reports/:
+   the directory is private, the names random, and the only way out is the
+   authenticated /jobs/<id>/artifact. A job checks for cancellation and counts
+   progress student by student. Finished jobs stay visible until their slot
+   is needed for a new one, which also deletes their artifact. A job that
+   changes the roster does it like a request, through the mutation queue,
+   with its thread as the pinner the reply goes to. Bulk imports are not a
+   kind: rosters come in as CSV files dropped into data/, which the watcher
+   thread already loads off the request path (see Live reload). */
+#define JOB_DIR "jobs"
+
+typedef int (*JobFn)(Job *j, const Dataset *d);
+
+typedef struct {
+    const char *name;
+    JobFn run;                      /* 0 done, 1 cancelled, -1 failed (j->error set) */
+    int priority;                   /* default */
+    int needs_semester;
+} JobKind;
+
+static const char *const JOB_STATES[] = { "queued", "running", "done", "failed", "cancelled" };
+static const char *const JOB_PRIORITY_NAMES[JOB_PRIORITIES] = { "high", "normal", "low" };
+
+static void job_lock(void) {
+    if (pthread_mutex_lock(&store->job_lock) == EOWNERDEAD)
+        pthread_mutex_consistent(&store->job_lock);
+}
+
+static void job_unlock(void) {
+    pthread_mutex_unlock(&store->job_lock);
+}
+
+/* open JOB_DIR/.<name>.tmp for j's artifact, under a random name ending in ext */
+static FILE *job_open(Job *j, const char *ext, char *tmp, size_t cap) {
+    unsigned char key[16];
+    if (getrandom(key, sizeof(key), 0) != (ssize_t)sizeof(key)) {
+        snprintf(j->error, sizeof(j->error), "cannot name report: %s", strerror(errno));
+        return NULL;
+    }
+    char name[64];
+    for (int k = 0; k < 16; ++k) snprintf(name + 2 * k, 3, "%02x", key[k]);
+    snprintf(name + 32, sizeof(name) - 32, "%s", ext);
+    mkdir(JOB_DIR, 0700);
+    snprintf(j->artifact, sizeof(j->artifact), "%s", name);
+    snprintf(tmp, cap, JOB_DIR "/.%s.tmp", name);
+    FILE *f = fopen(tmp, "w");
+    if (!f) snprintf(j->error, sizeof(j->error), "cannot create report: %s", strerror(errno));
+    return f;
+}
+
+/* finish the artifact: 0 once it is in place under its name, 1 if
+   cancelled, -1 on a write error */
+static int job_close(Job *j, FILE *f, const char *tmp, int cancelled) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), JOB_DIR "/%s", j->artifact);
+    if (fclose(f) != 0 && !cancelled) {
+        snprintf(j->error, sizeof(j->error), "write failed: %s", strerror(errno));
+        cancelled = -1;
+    }
+    if (cancelled || rename(tmp, path) != 0) {
+        unlink(tmp);
+        if (!cancelled) snprintf(j->error, sizeof(j->error), "rename failed: %s", strerror(errno));
+        return cancelled ? cancelled : -1;
+    }
+    return 0;
+}
+
+/* every live student as CSV */
+static int job_export(Job *j, const Dataset *d) {
+    char tmp[PATH_MAX];
+    FILE *f = job_open(j, ".csv", tmp, sizeof(tmp));
+    if (!f) return -1;
+    atomic_store(&j->total, d->count);
+    /* the console's export, in one pass: cancellable only before it starts */
+    int cancelled = atomic_load(&j->cancel);
+    if (!cancelled) core_export_csv(d, f);
+    atomic_store(&j->done, d->count);
+    return job_close(j, f, tmp, cancelled);
+}
+
+/* a semester's result sheet: marks per subject, SGPA and CGPA per student */
+static int job_results(Job *j, const Dataset *d) {
+    char tmp[PATH_MAX];
+    FILE *f = job_open(j, ".html", tmp, sizeof(tmp));
+    if (!f) return -1;
+    atomic_store(&j->total, d->count);
+    fprintf(f, "<!doctype html><html><head><meta charset='utf-8'><title>Results</title></head><body>");
+    fprintf(f, "<h2>Results - Semester %d</h2><table border='1' cellpadding='6'><tr><th>ID</th><th>Name</th>"
+               "<th>Subjects (marks)</th><th>SGPA</th><th>CGPA</th></tr>", j->semester);
+    int cancelled = 0;
+    Buf row = {0};                  /* one table row, names and titles escaped */
+    for (int i = 0; i < d->count && !(cancelled = atomic_load(&j->cancel)); ++i) {
+        const Student *st = &d->students[i];
+        atomic_store(&j->done, i + 1);
+        if (!st->exists || st->current_semester < j->semester) continue;
+        row.len = 0;
+        buf_printf(&row, "<tr><td>%d</td><td>", st->id);
+        buf_put_html(&row, st->name);
+        buf_puts(&row, "</td><td>");
+        const Enrollment *e = d->enrollments + st->first;
+        for (int k = 0; k < st->num_subjects; ++k) {
+            const SubjectRec *sub = &d->subjects[e[k].subject];
+            if (sub->semester != j->semester) continue;
+            buf_put_html(&row, sub->title);
+            if (e[k].marks >= 0) buf_printf(&row, " (%d)<br>", e[k].marks);
+            else buf_puts(&row, " (-)<br>");
+        }
+        double sgpa = core_gpa(d, i, j->semester, NULL), cgpa = core_gpa(d, i, 0, NULL);
+        if (sgpa >= 0) buf_printf(&row, "</td><td>%.2f</td>", sgpa);
+        else buf_puts(&row, "</td><td>-</td>");
+        if (cgpa >= 0) buf_printf(&row, "<td>%.2f</td></tr>", cgpa);
+        else buf_puts(&row, "<td>-</td></tr>");
+        if (row.oom) { snprintf(j->error, sizeof(j->error), "out of memory"); cancelled = -1; break; }
+        fwrite(row.data, 1, row.len, f);
+    }
+    buf_free(&row);
+    fprintf(f, "</table></body></html>");
+    return job_close(j, f, tmp, cancelled);
+}
+
+/* every stored CGPA re-derived from the marks, as one new version; the
+   artifact lists the students whose CGPA it changed (id, stored, derived) */
+static int job_recompute(Job *j, const Dataset *d) {
+    char tmp[PATH_MAX];
+    FILE *f = job_open(j, ".csv", tmp, sizeof(tmp));
+    if (!f) return -1;
+    atomic_store(&j->total, d->count);
+    fprintf(f, "sap,stored_cgpa,cgpa\n");
+    int cancelled = 0;
+    for (int i = 0; i < d->count && !(cancelled = atomic_load(&j->cancel)); ++i) {
+        const Student *st = &d->students[i];
+        atomic_store(&j->done, i + 1);
+        if (!st->exists) continue;
+        double g = core_gpa(d, i, 0, NULL);
+        float cgpa = g < 0.0 ? 0.0f : (float)g;
+        if (cgpa != st->cgpa) fprintf(f, "%d,%.3f,%.3f\n", st->id, st->cgpa, cgpa);
+    }
+    if (!cancelled) {
+        Mutation cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.op = MUT_RECOMPUTE;
+        unsigned int first = mut_begin();
+        mut_wait(first, mut_push(&cmd));
+    }
+    return job_close(j, f, tmp, cancelled);
+}
+
+static const JobKind JOB_KINDS[] = {
+    { "export",    job_export,    JOB_LOW,    0 },
+    { "results",   job_results,   JOB_NORMAL, 1 },
+    { "recompute", job_recompute, JOB_LOW,    0 },
+};
+#define JOB_KIND_COUNT ((int)(sizeof(JOB_KINDS) / sizeof(JOB_KINDS[0])))
+
+static int job_kind_find(const char *name) {
+    for (int k = 0; k < JOB_KIND_COUNT; ++k) if (strcmp(JOB_KINDS[k].name, name) == 0) return k;
+    return -1;
+}
+
+/* queue a job; its id, or 0 when every slot holds a queued or running job */
+static unsigned int job_submit(int kind, int priority, int semester) {
+    job_lock();
+    Job *slot = NULL;
+    for (int i = 0; i < JOB_MAX; ++i) {
+        Job *j = &store->jobs[i];
+        if (j->id && (j->state == JOB_QUEUED || j->state == JOB_RUNNING)) continue;
+        if (!slot || !j->id || (slot->id && j->finished < slot->finished)) slot = j;
+        if (!j->id) break;
+    }
+    unsigned int id = 0;
+    if (slot) {
+        if (slot->artifact[0]) {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), JOB_DIR "/%s", slot->artifact);
+            unlink(path);
+        }
+        memset(slot, 0, sizeof(*slot));
+        id = slot->id = ++store->job_next;
+        slot->kind = (unsigned char)kind;
+        slot->priority = (unsigned char)priority;
+        slot->semester = semester;
+        slot->state = JOB_QUEUED;
+        slot->created = (long long)time(NULL);
+    }
+    job_unlock();
+    if (id) {
+        atomic_fetch_add(&store->job_wake, 1);
+        futex_wake(&store->job_wake);
+    }
+    return id;
+}
+
+/* the queued job to run next, marked running; NULL if none */
+static Job *job_claim(void) {
+    job_lock();
+    Job *best = NULL;
+    for (int i = 0; i < JOB_MAX; ++i) {
+        Job *j = &store->jobs[i];
+        if (!j->id || j->state != JOB_QUEUED) continue;
+        if (!best || j->priority < best->priority || (j->priority == best->priority && j->id < best->id)) best = j;
+    }
+    if (best) {
+        best->state = JOB_RUNNING;
+        best->started = (long long)time(NULL);
+    }
+    job_unlock();
+    return best;
+}
+
+static void *job_thread_main(void *arg) {
+    int pinner = PIN_JOB0 + (int)(intptr_t)arg;
+    pin_self = pinner;
+    mut_ticket = atomic_load(&store->replies[pinner].done);
+    for (;;) {
+        unsigned int wake = atomic_load(&store->job_wake);
+        Job *j = job_claim();
+        if (!j) { futex_wait(&store->job_wake, wake, -1); continue; }
+        const Dataset *d = store_enter(pinner);
+        int rc = JOB_KINDS[j->kind].run(j, d);
+        store_exit(pinner);
+        job_lock();
+        j->state = rc == 0 ? JOB_DONE : rc > 0 ? JOB_CANCELLED : JOB_FAILED;
+        j->finished = (long long)time(NULL);
+        if (rc != 0) j->artifact[0] = 0;
+        job_unlock();
+    }
+    return NULL;
+}
+
+/* the job table starts empty, so artifacts of an earlier run are unreachable:
+   clear them out, then start the pool */
+static void jobs_start(void) {
+    DIR *dir = opendir(JOB_DIR);
+    for (struct dirent *de; dir && (de = readdir(dir)); ) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), JOB_DIR "/%s", de->d_name);
+        unlink(path);
+    }
+    if (dir) closedir(dir);
+    for (int i = 0; i < JOB_THREADS; ++i) {
+        pthread_t t;
+        if (pthread_create(&t, NULL, job_thread_main, (void *)(intptr_t)i) == 0) pthread_detach(t);
+    }
+}
+
+/* send a response with an explicit body length */
+static void conn_send(int client, const void *data, size_t len);
+
+/* extra: additional header lines, each ending in CRLF ("" for none) */
+static void send_response_headers(int client, const char *status, const char *ctype, const char *extra,
+                                  const char *body, size_t len) {
+    char header[768];
+    int hlen = snprintf(header, sizeof(header),
+                        "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%sConnection: close\r\n\r\n",
+                        status, ctype, len, extra);
+    conn_send(client, header, (size_t)hlen);
+    if (len) conn_send(client, body, len);
+}
+
+static void send_response(int client, const char *status, const char *ctype, const char *body, size_t len) {
+    send_response_headers(client, status, ctype, "", body, len);
+}
+
 /* send text/html response */
 static void send_text(int client, const char *status, const char *ctype, const char *body) {
-    char header[512];
-    int hlen = snprintf(header, sizeof(header),
-                        "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
-                        status, ctype, strlen(body));
-    send(client, header, hlen, 0);
-    send(client, body, strlen(body), 0);
-}
-
-/* Read request (headers and body) into buffer (simple) */
-#define REQBUF 262144
-static int read_request(int client, char *buf, int bufsz) {
-    int total = 0, r;
-    while ((r = recv(client, buf + total, bufsz - total - 1, 0)) > 0) {
-        total += r;
-        if (total > 4 && strstr(buf, "\r\n\r\n")) break;
-        if (total > bufsz - 100) break;
-    }
-    if (r <= 0 && total == 0) return -1;
-    buf[total] = 0;
-    /* if Content-Length present, ensure body fully read */
-    char *cl = strcasestr(buf, "Content-Length:");
-    if (cl) {
-        int clv = atoi(cl + strlen("Content-Length:"));
-        char *hdr_end = strstr(buf, "\r\n\r\n");
-        int bodylen = hdr_end ? (int)strlen(hdr_end + 4) : 0;
-        int toread = clv - bodylen;
-        while (toread > 0 && (r = recv(client, buf + total, bufsz - total - 1, 0)) > 0) {
-            total += r;
-            toread -= r;
+    send_response(client, status, ctype, body, strlen(body));
+}
+
+/* ---------- Connections ----------
+   Sockets are non-blocking and driven by one epoll loop, so a slow or idle
+   client only ever holds its own Conn. Every connection carries an absolute
+   deadline for its current phase (head, body, response) on a timer wheel;
+   a client that misses it is answered 408 where that still makes sense and
+   evicted. Responses are queued into the Conn by send_* and written out as
+   the socket accepts them. */
+#define CONN_FD_MAX 4096            /* fds at or above this are refused */
+#define HEAD_TIMEOUT_MS  10000      /* request line + headers, from accept */
+#define BODY_TIMEOUT_MS  30000      /* request body, from the end of the head */
+#define WRITE_TIMEOUT_MS 30000      /* response, from when it is queued */
+
+enum { CONN_HEAD, CONN_BODY, CONN_WRITE, CONN_STREAM, CONN_WAIT };
+
+/* finishes a parked write's response; see Parked writes */
+typedef void (*MutDoneFn)(int client, Arena *a, void *ctx, int sum);
+
+/* per-connection request state; connections are pooled so the arena's
+   first block survives from one request to the next */
+typedef struct Conn {
+    int fd;
+    int state;                  /* CONN_HEAD / CONN_BODY / CONN_WRITE / CONN_STREAM / CONN_WAIT */
+    char head[HEAD_CAP + 1];
+    size_t head_len;            /* bytes received into head */
+    HttpParser hp;
+    HttpRequest req;
+    char *body;
+    size_t body_have, body_want;
+    Buf out;                    /* queued response, arena-backed */
+    size_t out_sent;
+    long long deadline;         /* ms on CLOCK_MONOTONIC */
+    struct Conn *tprev, *tnext; /* timer wheel slot list */
+    int timed;                  /* linked into the wheel */
+    Arena arena;                /* request-scoped allocations, reset per response */
+    int stream;                 /* the handler turned this into an event stream */
+    int sub_student, sub_semester;  /* stream filter, 0 = any */
+    char *sq;                   /* stream queue, SSE_QUEUE_CAP bytes */
+    size_t sq_off, sq_len;      /* unsent bytes are sq[sq_off .. sq_len) */
+    int sq_blocked;             /* waiting for EPOLLOUT */
+    struct Conn *sprev, *snext; /* subscriber list */
+    MutDoneFn wait_done;        /* set: answer once tickets wait_first..wait_last are done */
+    void *wait_ctx;
+    unsigned int wait_first, wait_last;
+    struct Conn *wprev, *wnext; /* parked list */
+    struct Conn *next_free;
+} Conn;
+
+static Conn *conn_pool;
+static Conn *conn_by_fd[CONN_FD_MAX];
+static int conn_count;                  /* open connections */
+
+static Conn *conn_acquire(int fd) {
+    Conn *c = conn_pool;
+    if (c) conn_pool = c->next_free;
+    else if (!(c = calloc(1, sizeof(Conn)))) return NULL;
+    c->fd = fd;
+    c->state = CONN_HEAD;
+    c->head_len = 0;
+    c->body = NULL;
+    c->body_have = c->body_want = 0;
+    c->out = (Buf){ .arena = &c->arena };
+    c->out_sent = 0;
+    c->timed = 0;
+    c->stream = 0;
+    c->wait_done = NULL;
+    http_parser_init(&c->hp);
+    conn_by_fd[fd] = c;
+    conn_count++;
+    return c;
+}
+
+static void conn_release(Conn *c) {
+    conn_by_fd[c->fd] = NULL;
+    conn_count--;
+    arena_reset(&c->arena);
+    c->next_free = conn_pool;
+    conn_pool = c;
+}
+
+/* queue response bytes on the connection owning this socket */
+static void conn_send(int client, const void *data, size_t len) {
+    Conn *c = client >= 0 && client < CONN_FD_MAX ? conn_by_fd[client] : NULL;
+    if (c) buf_append(&c->out, data, len);
+}
+
+/* ---------- Admission control ----------
+   Open connections are the server's queue. Past max_conns new connections
+   are refused at accept with a canned 503; below that, expensive routes are
+   shed first (from half of max_conns) and ordinary ones next (from three
+   quarters), so static assets and the entry pages keep flowing while
+   report generation backs off. Both limits and the listen backlog come
+   from the environment (MAX_CONNS, LISTEN_BACKLOG). */
+#define RETRY_AFTER "2"             /* seconds */
+
+/* what a route costs to serve */
+enum { COST_LIGHT, COST_NORMAL, COST_HEAVY };
+
+static int max_conns = 1024;
+static int listen_backlog = 511;
+
+static int admit(int cost) {
+    if (cost == COST_HEAVY) return conn_count <= max_conns / 2;
+    if (cost == COST_NORMAL) return conn_count <= max_conns * 3 / 4;
+    return 1;
+}
+
+static const char OVERLOADED[] =
+    "HTTP/1.1 503 Service Unavailable\r\nContent-Type: text/plain\r\nContent-Length: 12\r\n"
+    "Retry-After: " RETRY_AFTER "\r\nConnection: close\r\n\r\nServer busy\n";
+
+static void send_overloaded(int client) {
+    conn_send(client, OVERLOADED, sizeof(OVERLOADED) - 1);
+}
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* ---------- Timer wheel ----------
+   One slot per tick, holding the connections whose deadline falls in it.
+   Deadlines further out than a full turn wait in their slot for a later
+   lap; arming and cancelling are O(1) list operations. */
+#define WHEEL_TICK_MS 250
+#define WHEEL_SLOTS 256             /* power of two: 64 s per turn */
+
+static Conn *wheel[WHEEL_SLOTS];
+static long long wheel_tick;        /* next tick to be processed */
+
+static void timer_clear(Conn *c) {
+    if (!c->timed) return;
+    if (c->tprev) c->tprev->tnext = c->tnext;
+    else wheel[(c->deadline / WHEEL_TICK_MS) & (WHEEL_SLOTS - 1)] = c->tnext;
+    if (c->tnext) c->tnext->tprev = c->tprev;
+    c->timed = 0;
+}
+
+static void timer_set(Conn *c, long long deadline) {
+    timer_clear(c);
+    c->deadline = deadline;
+    Conn **slot = &wheel[(deadline / WHEEL_TICK_MS) & (WHEEL_SLOTS - 1)];
+    c->tprev = NULL;
+    c->tnext = *slot;
+    if (*slot) (*slot)->tprev = c;
+    *slot = c;
+    c->timed = 1;
+}
+
+/* ---------- Event stream ----------
+   GET /events turns its connection into a text/event-stream subscriber.
+   Every process pumps the Store's change feed once per loop turn and fans
+   each new event out to its own subscribers whose filter matches. A
+   subscriber's queue is bounded: one that falls SSE_QUEUE_CAP behind is
+   dropped, and picks up from the ring with Last-Event-ID when its browser
+   reconnects. A comment line every SSE_PING_MS keeps proxies from timing
+   the stream out and finds peers that went away silently. */
+#define SSE_QUEUE_CAP 16384
+#define SSE_PING_MS 15000
+
+static int epoll_fd = -1;               /* the event loop's */
+
+static void conn_close(Conn *c);
+
+static Conn *sse_subs;                  /* this process's subscribers */
+static int sse_count;
+static unsigned long long feed_seen;    /* last feed event fanned out */
+
+static void sse_unlink(Conn *c) {
+    if (c->sprev) c->sprev->snext = c->snext;
+    else sse_subs = c->snext;
+    if (c->snext) c->snext->sprev = c->sprev;
+    sse_count--;
+    free(c->sq);
+    c->sq = NULL;
+}
+
+static void sse_watch(Conn *c, int want_out) {
+    if (c->sq_blocked == want_out) return;
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP | (want_out ? EPOLLOUT : 0), .data.ptr = c };
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->sq_blocked = want_out;
+}
+
+/* write what the socket takes; -1 if the subscriber is gone */
+static int sse_flush(Conn *c) {
+    while (c->sq_off < c->sq_len) {
+        ssize_t w = send(c->fd, c->sq + c->sq_off, c->sq_len - c->sq_off, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { sse_watch(c, 1); return 0; }
+        if (w <= 0) return -1;
+        c->sq_off += (size_t)w;
+    }
+    c->sq_off = c->sq_len = 0;
+    sse_watch(c, 0);
+    return 0;
+}
+
+/* append to the subscriber's queue; -1 if it is full */
+static int sse_queue(Conn *c, const char *data, size_t len) {
+    if (c->sq_len + len > SSE_QUEUE_CAP && c->sq_off > 0) {
+        memmove(c->sq, c->sq + c->sq_off, c->sq_len - c->sq_off);
+        c->sq_len -= c->sq_off;
+        c->sq_off = 0;
+    }
+    if (c->sq_len + len > SSE_QUEUE_CAP) return -1;
+    memcpy(c->sq + c->sq_len, data, len);
+    c->sq_len += len;
+    return 0;
+}
+
+static int sse_wants(const Conn *c, const FeedEvent *e) {
+    if (c->sub_student && e->student && e->student != c->sub_student) return 0;
+    if (c->sub_semester && e->semester && e->semester != c->sub_semester) return 0;
+    return 1;
+}
+
+static int sse_format(char *out, size_t cap, unsigned long long seq, const FeedEvent *e) {
+    int n = snprintf(out, cap, "id: %llu\nevent: %s\ndata: %s\n\n", seq, e->type, e->data);
+    return n < 0 ? 0 : (size_t)n < cap ? n : (int)cap - 1;
+}
+
+/* queue the events after last_id that are still in the ring and already
+   fanned out here (later ones reach the stream through feed_pump) */
+static void sse_replay(Conn *c, unsigned long long last_id) {
+    if (feed_seen - last_id > FEED_RING) last_id = feed_seen - FEED_RING;
+    for (unsigned long long seq = last_id + 1; seq <= feed_seen; ++seq) {
+        FeedEvent e;
+        char msg[FEED_DATA_MAX + 64];
+        if (!feed_read(seq, &e) || !sse_wants(c, &e)) continue;
+        int n = sse_format(msg, sizeof(msg), seq, &e);
+        buf_append(&c->out, msg, (size_t)n);
+    }
+}
+
+/* the handler set c->stream: keep the connection, with what it queued as
+   the start of the stream */
+static void sse_start(Conn *c) {
+    c->state = CONN_STREAM;
+    c->sq = malloc(SSE_QUEUE_CAP);
+    c->sq_off = c->sq_len = 0;
+    c->sq_blocked = -1;
+    c->sprev = NULL;
+    c->snext = sse_subs;
+    if (sse_subs) sse_subs->sprev = c;
+    sse_subs = c;
+    sse_count++;
+    if (!c->sq || c->out.oom || sse_queue(c, c->out.data, c->out.len) < 0) { conn_close(c); return; }
+    arena_reset(&c->arena);
+    c->out = (Buf){ .arena = &c->arena };
+    timer_set(c, now_ms() + SSE_PING_MS);
+    if (sse_flush(c) < 0) conn_close(c);
+}
+
+/* readable or writable subscriber: anything it sends is ignored, EOF ends it */
+static void sse_ready(Conn *c, unsigned int events) {
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        char sink[512];
+        for (;;) {
+            ssize_t r = recv(c->fd, sink, sizeof(sink), 0);
+            if (r > 0) continue;
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            conn_close(c);
+            return;
         }
-        buf[total] = 0;
     }
-    return total;
+    if ((events & EPOLLOUT) && sse_flush(c) < 0) conn_close(c);
 }
 
-/* Serve a static report file from reports/ */
-static void serve_report_file(int client, const char *name) {
-    if (strstr(name, "..")) {
-        const char *bad = "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length:11\r\n\r\nBad request";
-        send(client, bad, strlen(bad), 0);
+/* ping timer: a stream that could not take the last ping is dropped */
+static void sse_ping(Conn *c) {
+    static const char ping[] = ": ping\n\n";
+    if (c->sq_len > c->sq_off || sse_queue(c, ping, sizeof(ping) - 1) < 0 || sse_flush(c) < 0) {
+        conn_close(c);
         return;
     }
-    char path[PATH_MAX];
-    snprintf(path, sizeof(path), "reports/%s", name);
+    timer_set(c, now_ms() + SSE_PING_MS);
+}
+
+/* fan events published since the last turn out to this process's streams */
+static void feed_pump(void) {
+    unsigned long long head = atomic_load(&store->feed_seq);
+    if (head == feed_seen) return;
+    if (!sse_subs) { feed_seen = head; return; }
+    if (head - feed_seen > FEED_RING) feed_seen = head - FEED_RING;
+    for (; feed_seen < head; ++feed_seen) {
+        FeedEvent e;
+        char msg[FEED_DATA_MAX + 64];
+        if (!feed_read(feed_seen + 1, &e)) continue;
+        int n = sse_format(msg, sizeof(msg), feed_seen + 1, &e);
+        for (Conn *c = sse_subs, *next; c; c = next) {
+            next = c->snext;
+            if (sse_wants(c, &e) && sse_queue(c, msg, (size_t)n) < 0) conn_close(c);
+        }
+    }
+    for (Conn *c = sse_subs, *next; c; c = next) {
+        next = c->snext;
+        if (c->sq_len > c->sq_off && !c->sq_blocked && sse_flush(c) < 0) conn_close(c);
+    }
+}
+
+/* ---------- Parked writes ----------
+   A write's handler queues its commands and returns without waiting for
+   them: sleeping on the reply futex would hold this process's whole event
+   loop through the applier's batch, its fsync, and any checkpoint or
+   reload the batch queues behind. Instead it hands mut_reply_later its
+   tickets and a function that finishes the response from their summed
+   results. The connection is parked off epoll (a hangup still reports)
+   until the applier signals this process's eventfd and the tickets are
+   done. Results wait in the reply slot's ring until then; between a
+   ticket being done and its connection being finished this process
+   pushes at most two loop turns of requests (64 each, at most
+   MAX_STUDENTS / MUT_STUDENTS commands apiece), fewer than MUT_RESULTS. */
+static Conn *conn_waiting;              /* this process's parked connections */
+#define EV_WAKE ((void *)&conn_waiting) /* epoll data of the applier's eventfd */
+
+/* answer the running request with done(client, arena, ctx, sum) once this
+   thread's tickets first..last are applied; ctx lives in the request's
+   arena */
+static void mut_reply_later(int client, unsigned int first, unsigned int last, MutDoneFn done, void *ctx) {
+    Conn *c = client >= 0 && client < CONN_FD_MAX ? conn_by_fd[client] : NULL;
+    if (!c) return;
+    c->wait_done = done;
+    c->wait_ctx = ctx;
+    c->wait_first = first;
+    c->wait_last = last;
+}
+
+static void wait_link(Conn *c) {
+    c->state = CONN_WAIT;
+    c->wprev = NULL;
+    c->wnext = conn_waiting;
+    if (conn_waiting) conn_waiting->wprev = c;
+    conn_waiting = c;
+}
+
+static void wait_unlink(Conn *c) {
+    if (c->wprev) c->wprev->wnext = c->wnext;
+    else conn_waiting = c->wnext;
+    if (c->wnext) c->wnext->wprev = c->wprev;
+}
+
+static const char *http_status_text(int status) {
+    switch (status) {
+        case 400: return "400 Bad Request";
+        case 408: return "408 Request Timeout";
+        case 413: return "413 Payload Too Large";
+        case 431: return "431 Request Header Fields Too Large";
+        case 501: return "501 Not Implemented";
+        default:  return "500 Internal Server Error";
+    }
+}
+
+/* Advance reading one request as far as the socket allows: 0 = need more
+   bytes, 1 = request complete, -1 = peer gone, otherwise an HTTP error
+   status. The head is parsed incrementally as it arrives, then the body is
+   streamed straight into its own buffer sized from Content-Length. */
+static int conn_read(Conn *c) {
+    while (c->state == CONN_HEAD) {
+        ssize_t r = recv(c->fd, c->head + c->head_len, HEAD_CAP - c->head_len, 0);
+        if (r < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+        if (r == 0) return -1;
+        c->head_len += (size_t)r;
+        int rc = http_parse(&c->hp, c->head, c->head_len);
+        if (rc == HP_NEED_MORE) continue;
+        if (rc == HP_ERROR) return c->hp.status;
+        c->head[c->head_len] = 0;
+        http_request_from_parser(&c->req, &c->hp, c->head);
+
+        c->body_want = c->hp.content_length > 0 ? (size_t)c->hp.content_length : 0;
+        c->body = arena_alloc(&c->arena, c->body_want + 1);
+        if (!c->body) return 500;
+        size_t have = c->head_len - c->hp.head_len;
+        if (have > c->body_want) have = c->body_want;   /* ignore pipelined bytes */
+        memcpy(c->body, c->head + c->hp.head_len, have);
+        c->body_have = have;
+        c->state = CONN_BODY;
+        timer_set(c, now_ms() + BODY_TIMEOUT_MS);
+    }
+    while (c->body_have < c->body_want) {
+        ssize_t r = recv(c->fd, c->body + c->body_have, c->body_want - c->body_have, 0);
+        if (r < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+        if (r == 0) return -1;
+        c->body_have += (size_t)r;
+    }
+    c->body[c->body_have] = 0;
+    c->req.body = c->body;
+    c->req.body_len = c->body_have;
+    return 1;
+}
+
+/* Serve a file whole; .csv as text/csv, anything else as HTML */
+static void serve_file(int client, Arena *a, const char *path) {
     FILE *f = fopen(path, "rb");
     if (!f) {
         const char *notf = "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length:9\r\n\r\nNot found";
-        send(client, notf, strlen(notf), 0);
+        conn_send(client, notf, strlen(notf));
         return;
     }
     fseek(f, 0, SEEK_END);
     long sz = ftell(f);
     fseek(f, 0, SEEK_SET);
-    char *data = malloc(sz + 1);
-    if (!data) { fclose(f); const char *err = "HTTP/1.1 500 Internal\r\n\r\n"; send(client, err, strlen(err), 0); return; }
-    fread(data, 1, sz, f);
+    char *data = sz >= 0 ? arena_alloc(a, (size_t)sz + 1) : NULL;
+    if (!data) { fclose(f); const char *err = "HTTP/1.1 500 Internal\r\n\r\n"; conn_send(client, err, strlen(err)); return; }
+    sz = (long)fread(data, 1, (size_t)sz, f);
     data[sz] = 0;
     fclose(f);
+    const char *dot = strrchr(path, '.');
+    const char *ctype = dot && strcmp(dot, ".csv") == 0 ? "text/csv; charset=utf-8" : "text/html; charset=utf-8";
     char header[256];
-    int hlen = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=utf-8\r\nContent-Length: %ld\r\nConnection: close\r\n\r\n", sz);
-    send(client, header, hlen, 0);
-    send(client, data, sz, 0);
-    free(data);
+    int hlen = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %ld\r\nConnection: close\r\n\r\n", ctype, sz);
+    conn_send(client, header, (size_t)hlen);
+    conn_send(client, data, (size_t)sz);
+}
+
+/* Serve a static report file from reports/ */
+static void serve_report_file(int client, Arena *a, const char *name) {
+    if (strstr(name, "..")) {
+        const char *bad = "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length:11\r\n\r\nBad request";
+        conn_send(client, bad, strlen(bad));
+        return;
+    }
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "reports/%s", name);
+    serve_file(client, a, path);
+}
+
+/* ---------- Static assets ----------
+   Shared stylesheets are compiled in and served from memory under a
+   content-hashed URL (/static/<stem>.<hash>.<ext>), so they can be cached
+   as immutable: any change to the content changes the URL the pages link. */
+enum { ASSET_SITE_CSS, ASSET_COUNT };
+
+typedef struct {
+    const char *name;               /* stem.ext, e.g. site.css */
+    const char *ctype;
+    const char *body;
+    size_t len;
+    char url[64];                   /* /static/site.<hash>.css */
+    char etag[16];
+} StaticAsset;
+
+/* One stylesheet for every page; pages pick their look with a body class. */
+static const char SITE_CSS[] =
+    "body.landing{margin:0;font-family:Inter,Arial,Helvetica,sans-serif;background:linear-gradient(135deg,#f0f6ff 0%,#ffffff 40%,#f7f2ff 100%);min-height:100vh;display:flex;align-items:center;justify-content:center}\n"
+    ".landing .wrap{max-width:1100px;width:95%;margin:40px auto;background:rgba(255,255,255,0.95);border-radius:12px;padding:26px;box-shadow:0 8px 28px rgba(20,20,50,0.08)}\n"
+    ".landing h1{margin:0;font-size:28px;color:#12263a} .landing p.lead{color:#4b5563}\n"
+    ".landing .grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(260px,1fr));gap:16px;margin-top:18px}\n"
+    ".landing .card{background:#fff;border-radius:10px;padding:18px;border:1px solid rgba(20,20,60,0.04)}\n"
+    ".landing .card h3{margin:0 0 8px 0} .landing .card p{margin:0 0 12px 0;color:#333}\n"
+    ".landing input,.landing textarea,.landing button,.landing select{width:100%;padding:8px;border-radius:6px;border:1px solid #e6eef8;font-size:14px}\n"
+    ".landing button{cursor:pointer;background:linear-gradient(180deg,#2b6ef6,#215bd6);color:white;border:none;padding:10px 12px}\n"
+    ".landing .small{font-size:13px;color:#6b7280} .landing .muted{color:#6b7280;font-size:13px;margin-top:8px}\n"
+    "@media(max-width:600px){.landing .wrap{padding:14px}}\n"
+    "body.dash{font-family:Inter,Arial;margin:18px}\n"
+    ".dash .card{background:#fff;padding:18px;border-radius:10px;box-shadow:0 6px 18px rgba(0,0,0,0.06);max-width:1000px;margin:auto}\n"
+    ".dash table{width:100%;border-collapse:collapse} .dash table th,.dash table td{padding:8px;border:1px solid #eee;text-align:left;font-size:14px}\n"
+    "body.admin{font-family:Arial;margin:18px}\n"
+    ".admin .card{max-width:900px;padding:18px;border-radius:10px;background:#fff;border:1px solid #eee}\n"
+    ".admin input,.admin button,.admin textarea,.admin select{padding:8px;margin:6px 0;width:100%}\n"
+    ".admin button{background:#0b69ff;color:#fff;border:none;border-radius:6px}\n";
+
+static StaticAsset static_assets[ASSET_COUNT] = {
+    [ASSET_SITE_CSS] = { "site.css", "text/css; charset=utf-8", SITE_CSS, sizeof(SITE_CSS) - 1, "", "" },
+};
+
+static void static_init(void) {
+    for (int i = 0; i < ASSET_COUNT; ++i) {
+        StaticAsset *sa = &static_assets[i];
+        unsigned int h = 2166136261u;   /* FNV-1a over the content */
+        for (size_t k = 0; k < sa->len; ++k) { h ^= (unsigned char)sa->body[k]; h *= 16777619u; }
+        const char *dot = strrchr(sa->name, '.');
+        snprintf(sa->url, sizeof(sa->url), "/static/%.*s.%08x%s", (int)(dot - sa->name), sa->name, h, dot);
+        snprintf(sa->etag, sizeof(sa->etag), "\"%08x\"", h);
+    }
+}
+
+static const char *static_url(int asset) {
+    return static_assets[asset].url;
+}
+
+/* GET /static/<name>: only the current hashed URL is served; it never changes
+   content, so clients may keep it for a year without revalidating */
+static void serve_static(int client, const HttpRequest *rq, const char *name) {
+    for (int i = 0; i < ASSET_COUNT; ++i) {
+        const StaticAsset *sa = &static_assets[i];
+        if (strcmp(name, sa->url + 8) != 0) continue;     /* past "/static/" */
+        char extra[128];
+        snprintf(extra, sizeof(extra), "Cache-Control: public, max-age=31536000, immutable\r\nETag: %s\r\n", sa->etag);
+        Slice inm = http_header(rq, "If-None-Match");
+        if (inm.p && inm.n == strlen(sa->etag) && memcmp(inm.p, sa->etag, inm.n) == 0)
+            send_response_headers(client, "304 Not Modified", sa->ctype, extra, NULL, 0);
+        else
+            send_response_headers(client, "200 OK", sa->ctype, extra, sa->body, sa->len);
+        return;
+    }
+    send_text(client, "404 Not Found", "text/plain", "Not found");
 }
 
 /* build landing page (signup includes extra fields) */
-static char *build_landing_page(void) {
+static char *build_landing_page(Arena *a) {
     ensure_reports_dir();
     const char *html_start =
         "<!doctype html><html><head><meta charset='utf-8'><title>Student System</title>"
         "<meta name='viewport' content='width=device-width,initial-scale=1'/>"
-        "<style>"
-        "body{margin:0;font-family:Inter,Arial,Helvetica,sans-serif;background:linear-gradient(135deg,#f0f6ff 0%,#ffffff 40%,#f7f2ff 100%);min-height:100vh;display:flex;align-items:center;justify-content:center}"
-        ".wrap{max-width:1100px;width:95%;margin:40px auto;background:rgba(255,255,255,0.95);border-radius:12px;padding:26px;box-shadow:0 8px 28px rgba(20,20,50,0.08)}"
-        "h1{margin:0;font-size:28px;color:#12263a} p.lead{color:#4b5563}"
-        ".grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(260px,1fr));gap:16px;margin-top:18px}"
-        ".card{background:#fff;border-radius:10px;padding:18px;border:1px solid rgba(20,20,60,0.04)}"
-        ".card h3{margin:0 0 8px 0} .card p{margin:0 0 12px 0;color:#333}"
-        "input,textarea,button,select{width:100%;padding:8px;border-radius:6px;border:1px solid #e6eef8;font-size:14px}"
-        "button{cursor:pointer;background:linear-gradient(180deg,#2b6ef6,#215bd6);color:white;border:none;padding:10px 12px}"
-        ".small{font-size:13px;color:#6b7280} .muted{color:#6b7280;font-size:13px;margin-top:8px}"
-        "@media(max-width:600px){.wrap{padding:14px}}"
-        "</style></head><body><div class='wrap'>"
+        "<link rel='stylesheet' href='%s'/></head><body class='landing'><div class='wrap'>"
         "<h1>Student Record & Result Management</h1>"
         "<p class='lead'>Choose an option to continue — Admin login, Student sign up, or Student sign in.</p>"
         "<div class='grid'>";
@@ -312,7 +1727,7 @@ static char *build_landing_page(void) {
         "<div class='card'>"
         "<h3>Student Sign In</h3>"
         "<p>Sign in to view your dashboard (attendance, marks, SGPA, CGPA).</p>"
-        "<form method='get' action='/dashboard'>"
+        "<form method='post' action='/login'>"
         "<input name='id' placeholder='Student ID' required />"
         "<input name='pass' placeholder='Password' type='password' required />"
         "<div style='margin-top:8px'><button>Sign in</button></div>"
@@ -321,80 +1736,154 @@ static char *build_landing_page(void) {
 
     const char *footer = "</div><p class='small'>Demo by Tanay Sah & Mahika Jaglan — for demonstration only.</p></div></body></html>";
 
-    size_t cap = strlen(html_start) + strlen(admin_card) + strlen(signup_card) + strlen(signin_card) + strlen(footer) + 256;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    strcpy(buf, html_start);
-    strcat(buf, admin_card);
-    strcat(buf, signup_card);
-    strcat(buf, signin_card);
-    strcat(buf, footer);
-    return buf;
+    Buf b = { .arena = a };
+    buf_printf(&b, html_start, static_url(ASSET_SITE_CSS));
+    buf_puts(&b, admin_card);
+    buf_puts(&b, signup_card);
+    buf_puts(&b, signin_card);
+    buf_puts(&b, footer);
+    return buf_finish(&b);
+}
+
+/* ---------- Roster index ----------
+   Student ids and subject titles of the dataset the request sees, through
+   a process-local core index. core_index_refresh rebuilds it when the
+   request sees another published version, or the roster has grown
+   (requests only ever append). */
+static CoreIndex roster_ix;
+
+static const CoreIndex *roster_index(void) {
+    core_index_refresh(&roster_ix, db);
+    return &roster_ix;
+}
+
+/* slot of the student with this id, or -1 */
+static int student_slot_by_id(int id) {
+    return core_student_slot(roster_index(), db, id);
+}
+
+/* ---------- Sorted roster ----------
+   Existing students ordered by id, and again grouped by current semester
+   (id order within each group), rebuilt like the roster index. Listing
+   pages are keyset-paginated over these: the cursor is the last id shown
+   (?after=<id>&limit=<n>), so a page costs a binary search plus the rows
+   it shows, and a student registered meanwhile lands where its id sorts
+   instead of shifting every later page. Totals are the group sizes. */
+#define PAGE_SIZE_MAX 500
+
+static int page_size = 50;                  /* default rows per page, PAGE_SIZE */
+
+static int sorted_ids[MAX_STUDENTS];        /* slots by id */
+static int sorted_sem[MAX_STUDENTS];        /* slots by (semester, id) */
+static int sem_start[10];                   /* sorted_sem[sem_start[s] .. sem_start[s+1]); 0 = other */
+static int sorted_count;
+static unsigned long long sorted_version;
+static int sorted_indexed = -1;
+
+static int cmp_slot_id(const void *a, const void *b) {
+    int x = db->students[*(const int *)a].id, y = db->students[*(const int *)b].id;
+    return (x > y) - (x < y);
+}
+
+static int sem_bucket(const Student *s) {
+    return (s->current_semester >= 1 && s->current_semester <= 8) ? s->current_semester : 0;
+}
+
+static void sorted_roster_rebuild(void) {
+    sorted_count = 0;
+    for (int i = 0; i < db->count; ++i)
+        if (db->students[i].exists) sorted_ids[sorted_count++] = i;
+    qsort(sorted_ids, (size_t)sorted_count, sizeof(int), cmp_slot_id);
+    /* counting sort by semester keeps the id order inside each group */
+    int fill[10] = {0};
+    for (int k = 0; k < sorted_count; ++k) fill[sem_bucket(&db->students[sorted_ids[k]])]++;
+    for (int s = 0, at = 0; s < 9; ++s) { sem_start[s] = at; at += fill[s]; fill[s] = sem_start[s]; }
+    sem_start[9] = sorted_count;
+    for (int k = 0; k < sorted_count; ++k) {
+        int slot = sorted_ids[k];
+        sorted_sem[fill[sem_bucket(&db->students[slot])]++] = slot;
+    }
+    sorted_version = db->version;
+    sorted_indexed = db->count;
+}
+
+/* the ordered slots of one semester (1-8), or of the whole roster (0) */
+static const int *sorted_roster(int semester, int *n) {
+    if (sorted_version != db->version || sorted_indexed != db->count) sorted_roster_rebuild();
+    if (semester < 1 || semester > 8) { *n = sorted_count; return sorted_ids; }
+    *n = sem_start[semester + 1] - sem_start[semester];
+    return sorted_sem + sem_start[semester];
+}
+
+/* position of the first slot whose id is greater than the cursor */
+static int sorted_seek(const int *v, int n, int after) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (db->students[v[mid]].id <= after) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
 }
 
-/* build simple student list HTML (used for admin to choose subject for attendance etc.) */
-static char *build_list_html(void) {
-    size_t cap = 8192;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    strcpy(buf, "<!doctype html><html><head><meta charset='utf-8'><title>Students</title></head><body><h2>Students</h2><table border='1' cellpadding='6'><tr><th>ID</th><th>Name</th><th>Year</th><th>Dept</th><th>Sem</th></tr>");
-    for (int i = 0; i < student_count; ++i) {
-        if (!students[i].exists) continue;
-        char row[1024];
-        snprintf(row, sizeof(row), "<tr><td>%d</td><td>%s</td><td>%d</td><td>%s</td><td>%d</td></tr>", students[i].id, students[i].name, students[i].year, students[i].dept, students[i].current_semester);
-        if (strlen(buf) + strlen(row) + 256 > cap) { cap *= 2; buf = realloc(buf, cap); }
-        strcat(buf, row);
-    }
-    strcat(buf, "</table><p><a href='/'>Back</a></p></body></html>");
-    return buf;
-}
-
-/* helper: collect unique subjects per semester and overall */
 typedef struct {
-    char name[MAX_SUB_NAME];
-    int semester; /* 0 = unknown, else 1..8 */
-} UniqueSub;
-
-static int map_subject_to_semester(const char *s) {
-    /* quick mapping based on the semester arrays in student_system.c
-       This mapping mirrors sem_subject lists: if names change on C side, update mapping here.
-       We'll implement a simple search across student data to estimate semester:
-       - If a student in sem X has this subject present and current_semester>=X, we guess sem X.
-       Fallback: 0 (unknown).
-    */
-    /* This wrapper cannot see sem_subjects directly (they are inside student_system.c),
-       so we approximate by scanning students for the subject and using their subject positions.
-       We'll pick most-common semester among students who have this subject.
-    */
-    int counts[9] = {0}; /* 0..8 */
-    for (int i = 0; i < student_count; ++i) {
-        if (!students[i].exists) continue;
-        for (int j = 0; j < students[i].num_subjects; ++j) {
-            if (strcmp(students[i].subjects[j].name, s) == 0) {
-                int sem = students[i].current_semester;
-                if (sem < 1 || sem > 8) sem = 0;
-                counts[sem]++;
-            }
-        }
+    int after;                      /* last id of the previous page, 0 for the first */
+    int limit;                      /* rows per page */
+} PageReq;
+
+static PageReq page_request(const FormTable *form) {
+    PageReq pg = { 0, page_size };
+    const char *v = form ? form_get(form, "after") : NULL;
+    if (v && atoi(v) > 0) pg.after = atoi(v);
+    v = form ? form_get(form, "limit") : NULL;
+    if (v && atoi(v) > 0) pg.limit = atoi(v) < PAGE_SIZE_MAX ? atoi(v) : PAGE_SIZE_MAX;
+    return pg;
+}
+
+/* "rows a-b of n" and first/next links; base is the page URL up to and
+   including the '?' or '&' the paging parameters follow */
+static void buf_put_pager(Buf *b, const char *base, const PageReq *pg,
+                          int pos, int shown, int total, int next_after) {
+    if (shown > 0) buf_printf(b, "<p class='small'>Showing %d&ndash;%d of %d", pos + 1, pos + shown, total);
+    else buf_printf(b, "<p class='small'>%d in total", total);
+    if (pg->after > 0) buf_printf(b, " &middot; <a href='%slimit=%d'>First page</a>", base, pg->limit);
+    if (next_after > 0) buf_printf(b, " &middot; <a href='%safter=%d&amp;limit=%d'>Next page</a>", base, next_after, pg->limit);
+    buf_puts(b, "</p>");
+}
+
+/* build simple student list HTML (used for admin to choose subject for attendance etc.) */
+static char *build_list_html(Arena *a, const PageReq *pg) {
+    int n;
+    const int *v = sorted_roster(0, &n);
+    int pos = sorted_seek(v, n, pg->after);
+    int end = (n - pos > pg->limit) ? pos + pg->limit : n;
+    Buf b = { .arena = a };
+    buf_puts(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Students</title></head><body><h2>Students</h2><table border='1' cellpadding='6'><tr><th>ID</th><th>Name</th><th>Year</th><th>Dept</th><th>Sem</th></tr>");
+    for (int k = pos; k < end; ++k) {
+        const Student *s = &db->students[v[k]];
+        buf_printf(&b, "<tr><td>%d</td><td>", s->id);
+        buf_put_html(&b, s->name);
+        buf_printf(&b, "</td><td>%d</td><td>", s->year);
+        buf_put_html(&b, s->dept);
+        buf_printf(&b, "</td><td>%d</td></tr>", s->current_semester);
     }
-    int best = 0; int bestc = 0;
-    for (int k=1;k<=8;++k) if (counts[k] > bestc) { bestc = counts[k]; best = k; }
-    return best;
+    buf_puts(&b, "</table>");
+    buf_put_pager(&b, "/list?", pg, pos, end - pos, n, end < n ? db->students[v[end - 1]].id : 0);
+    buf_puts(&b, "<p><a href='/'>Back</a></p></body></html>");
+    return buf_finish(&b);
 }
 
 /* Build student dashboard as HTML with attendance & marks, grouped by semester (latest first) */
-static char *build_student_dashboard(int idx) {
-    if (idx < 0 || idx >= student_count) return NULL;
-    Student *s = &students[idx];
-    char escaped_name[256]; html_escape_buf(s->name, escaped_name, sizeof(escaped_name));
-    /* Group subjects by semester using map_subject_to_semester */
-    Subject *bysem[9][MAX_SUBJECTS]; /* pointers into s->subjects */
+static char *build_student_dashboard(Arena *a, int idx) {
+    if (idx < 0 || idx >= db->count) return NULL;
+    Student *s = &db->students[idx];
+    /* Group enrollments by their subject's semester */
+    const Enrollment *bysem[9][MAX_ENROLLED];
     int bysem_count[9] = {0};
-    for (int i=0;i<9;++i) for (int j=0;j<MAX_SUBJECTS;++j) bysem[i][j]=NULL;
+    const Enrollment *en = db->enrollments + s->first;
     for (int i = 0; i < s->num_subjects; ++i) {
-        int sem = map_subject_to_semester(s->subjects[i].name);
-        if (sem < 0 || sem > 8) sem = 0;
-        bysem[sem][ bysem_count[sem]++ ] = &s->subjects[i];
+        int sem = db->subjects[en[i].subject].semester;
+        bysem[sem][ bysem_count[sem]++ ] = &en[i];
     }
     /* choose order: latest semester first, then descending, then unknown (0) last */
     int order[9]; int ordc=0;
@@ -409,863 +1898,1580 @@ static char *build_student_dashboard(int idx) {
     const char *tpl_start =
         "<!doctype html><html><head><meta charset='utf-8'><title>Dashboard</title>"
         "<meta name='viewport' content='width=device-width,initial-scale=1'/>"
-        "<style>body{font-family:Inter,Arial;margin:18px} .card{background:#fff;padding:18px;border-radius:10px;box-shadow:0 6px 18px rgba(0,0,0,0.06);max-width:1000px;margin:auto} table{width:100%;border-collapse:collapse} table th,table td{padding:8px;border:1px solid #eee;text-align:left;font-size:14px}</style>"
-        "</head><body><div class='card'>";
-
-    const char *tpl_end = "<p><a href='/'>← Back to Home</a></p></div></body></html>";
-
-    size_t cap = strlen(tpl_start) + 16384;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    strcpy(buf, tpl_start);
-    char header[1024];
-    char dept_esc[256]; html_escape_buf(s->dept, dept_esc, sizeof(dept_esc));
-    double cur_sgpa = compute_sgpa_local_for_subjects(s->subjects, s->num_subjects);
-    snprintf(header, sizeof(header),
-             "<h2>Welcome, %s</h2><p>ID: %d | Dept: %s | Year: %d | Current Semester: %d | Age: %d</p>"
-             "<p><strong>SGPA (computed):</strong> %.3f  &nbsp;&nbsp; <strong>Stored CGPA:</strong> %.3f (Credits: %d)</p>",
-             escaped_name, s->id, dept_esc, s->year, s->current_semester, s->age, cur_sgpa, s->cgpa, s->total_credits_completed);
-    strcat(buf, header);
+        "<link rel='stylesheet' href='%s'/>"
+        "</head><body class='dash'><div class='card'>";
+
+    const char *tpl_end = "<form method='post' action='/logout'><button>Sign out</button></form>"
+                          "<p><a href='/'>← Back to Home</a></p></div></body></html>";
+
+    Buf b = { .arena = a };
+    buf_printf(&b, tpl_start, static_url(ASSET_SITE_CSS));
+    int credits;
+    double cur_sgpa = core_gpa(db, idx, 0, &credits);
+    if (cur_sgpa < 0) cur_sgpa = 0.0;
+    buf_puts(&b, "<h2>Welcome, "); buf_put_html(&b, s->name);
+    buf_printf(&b, "</h2><p>ID: %d | Dept: ", s->id); buf_put_html(&b, s->dept);
+    buf_printf(&b, " | Year: %d | Current Semester: %d | Age: %d</p>"
+               "<p><strong>SGPA (computed):</strong> %.3f  &nbsp;&nbsp; <strong>Stored CGPA:</strong> %.3f (Credits: %d)</p>",
+               s->year, s->current_semester, s->age, cur_sgpa, s->cgpa, credits);
 
     /* Per-semester sections */
     for (int oi=0; oi<ordc; ++oi) {
         int sem = order[oi];
-        char sec[4096]; sec[0]=0;
-        if (sem == 0) snprintf(sec, sizeof(sec), "<h3>Other / Unknown Semester Subjects</h3>");
-        else snprintf(sec, sizeof(sec), "<h3>Semester %d</h3>", sem);
-        strcat(buf, sec);
+        if (sem == 0) buf_puts(&b, "<h3>Other / Unknown Semester Subjects</h3>");
+        else buf_printf(&b, "<h3>Semester %d</h3>", sem);
 
         /* attendance summary for this semester */
         int total_held = 0, total_att = 0;
         for (int i=0;i<bysem_count[sem];++i) {
-            total_held += bysem[sem][i]->classes_held;
-            total_att += bysem[sem][i]->classes_attended;
+            total_held += bysem[sem][i]->held;
+            total_att += bysem[sem][i]->attended;
         }
         double pct = (total_held == 0) ? 0.0 : ((double)total_att / total_held) * 100.0;
-        char attline[256];
-        snprintf(attline, sizeof(attline), "<p>Semester attendance: %d classes held overall, %d attended (%.1f%%)</p>", total_held, total_att, pct);
-        strcat(buf, attline);
+        buf_printf(&b, "<p>Semester attendance: %d classes held overall, %d attended (%.1f%%)</p>", total_held, total_att, pct);
 
         /* subject table */
-        strcat(buf, "<table><tr><th>#</th><th>Subject</th><th>Marks</th><th>Credits</th><th>GradePoint</th><th>Attendance</th></tr>");
+        buf_puts(&b, "<table><tr><th>#</th><th>Subject</th><th>Marks</th><th>Credits</th><th>GradePoint</th><th>Attendance</th></tr>");
         for (int i=0;i<bysem_count[sem];++i) {
-            Subject *sub = bysem[sem][i];
-            int held = sub->classes_held;
-            int att = sub->classes_attended;
+            const Enrollment *e = bysem[sem][i];
+            const SubjectRec *sub = &db->subjects[e->subject];
+            int held = e->held;
+            int att = e->attended;
             int pct_sub = (held==0)?0:(int)(((double)att/held)*100.0 + 0.5);
-            int gp = marks_to_grade_point_local(sub->marks);
-            char sname_esc[256]; html_escape_buf(sub->name, sname_esc, sizeof(sname_esc));
-            char row[512];
-            snprintf(row, sizeof(row), "<tr><td>%d</td><td>%s</td><td>%d</td><td>%d</td><td>%d</td><td>%d%% (%d/%d)</td></tr>",
-                     i+1, sname_esc, sub->marks, sub->credits, gp, pct_sub, att, held);
-            if (strlen(buf) + strlen(row) + 256 > cap) { cap *= 2; buf = realloc(buf, cap); }
-            strcat(buf, row);
+            buf_printf(&b, "<tr><td>%d</td><td>", i+1);
+            buf_put_html(&b, sub->title);
+            if (e->marks >= 0)
+                buf_printf(&b, "</td><td>%d</td><td>%d</td><td>%d</td>", e->marks, sub->credits, core_grade_point(e->marks));
+            else
+                buf_printf(&b, "</td><td>-</td><td>%d</td><td>-</td>", sub->credits);
+            buf_printf(&b, "<td>%d%% (%d/%d)</td></tr>", pct_sub, att, held);
         }
-        strcat(buf, "</table><br/>");
+        buf_puts(&b, "</table><br/>");
     }
 
-    strcat(buf, tpl_end);
-    return buf;
+    /* refresh when this student's marks or attendance change, instead of polling */
+    buf_printf(&b, "<script>var es=new EventSource('/events?student=%d');"
+                   "es.addEventListener('marks',function(){location.reload()});"
+                   "es.addEventListener('attendance',function(){location.reload()});</script>", s->id);
+    buf_puts(&b, tpl_end);
+    return buf_finish(&b);
 }
 
 /* build admin attendance semester selection page */
-static char *build_attendance_sem_select_page(void) {
-    size_t cap = 4096;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    strcpy(buf, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Choose Semester</title></head><body><h2>Mark Attendance - Step 1: Choose Semester</h2>");
-    strcat(buf, "<form method='get' action='/attendance-subjects'>Select semester: <select name='semester'>");
-    for (int i=1;i<=8;++i) {
-        char opt[64]; snprintf(opt, sizeof(opt), "<option value='%d'>Semester %d</option>", i, i);
-        strcat(buf, opt);
-    }
-    strcat(buf, "</select> <button>Next</button></form><p><a href='/'>Back</a></p></body></html>");
-    return buf;
-}
-
-/* build subject checklist for a selected semester (only subjects that exist for at least one student in that semester) */
-static char *build_attendance_subjects_page(int semester, const char *err) {
-    size_t cap = 16384;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    snprintf(buf, cap, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Subjects Sem %d</title></head><body><h2>Mark Attendance - Step 2: Choose Subject(s) - Semester %d</h2>", semester, semester);
-    if (err && err[0]) { strncat(buf, "<p style='color:red;'>", cap - strlen(buf) -1); strncat(buf, err, cap - strlen(buf) -1); strncat(buf, "</p>", cap - strlen(buf) -1); }
-    strncat(buf, "<form method='get' action='/attendance-mark'>", cap - strlen(buf) -1);
-    char list_title[256]; snprintf(list_title, sizeof(list_title), "<input type='hidden' name='semester' value='%d'/>", semester);
-    strncat(buf, list_title, cap - strlen(buf) -1);
-
-    /* collect unique subjects for this semester - only include subjects that are present in at least one student whose current_semester == semester */
-    char added[8192]; added[0]=0;
-    int found_any = 0;
-    for (int i=0;i<student_count;++i) {
-        if (!students[i].exists) continue;
-        if (students[i].current_semester != semester) continue;
-        for (int j=0;j<students[i].num_subjects;++j) {
-            const char *sname = students[i].subjects[j].name;
-            if (strstr(added, sname) == NULL) {
-                if (strlen(added) + strlen(sname) + 16 < sizeof(added)) {
-                    strcat(added, sname);
-                    strcat(added, "\n");
-                }
-            }
+static char *build_attendance_sem_select_page(Arena *a) {
+    Buf b = { .arena = a };
+    buf_puts(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Choose Semester</title></head><body><h2>Mark Attendance - Step 1: Choose Semester</h2>");
+    buf_puts(&b, "<form method='get' action='/attendance-subjects'>Select semester: <select name='semester'>");
+    for (int i=1;i<=8;++i) buf_printf(&b, "<option value='%d'>Semester %d</option>", i, i);
+    buf_puts(&b, "</select> <button>Next</button></form><p><a href='/'>Back</a></p></body></html>");
+    return buf_finish(&b);
+}
+
+/* build subject checklist for a selected semester from the subject table;
+   the page only depends on that table, so it is rendered once per semester
+   and kept until a reload replaces the table; marks and attendance writes
+   leave it alone */
+static char *attendance_subjects_cache[9];
+static unsigned long long attendance_subjects_version[9];
+static int attendance_subjects_count[9];
+
+static char *build_attendance_subjects_page(Arena *a, int semester, const char *err) {
+    int cacheable = !(err && err[0]);
+    if (cacheable && attendance_subjects_cache[semester]) {
+        if (attendance_subjects_version[semester] == db->subjects_version &&
+            attendance_subjects_count[semester] == db->subject_count) return attendance_subjects_cache[semester];
+        free(attendance_subjects_cache[semester]);
+        attendance_subjects_cache[semester] = NULL;
+    }
+    const CoreIndex *ix = roster_index();
+
+    Buf b = { .arena = cacheable ? NULL : a };
+    buf_printf(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Subjects Sem %d</title></head><body><h2>Mark Attendance - Step 2: Choose Subject(s) - Semester %d</h2>", semester, semester);
+    if (err && err[0]) { buf_puts(&b, "<p style='color:red;'>"); buf_put_html(&b, err); buf_puts(&b, "</p>"); }
+    buf_puts(&b, "<form method='get' action='/attendance-mark'>");
+    buf_printf(&b, "<input type='hidden' name='semester' value='%d'/>", semester);
+
+    if (ix->sem_count[semester] == 0) {
+        buf_puts(&b, "<p>No subjects found for that semester.</p>");
+        buf_puts(&b, "<p><a href='/attendance'>Back</a></p></form></body></html>");
+    } else {
+        buf_puts(&b, "<ul style='list-style:none;padding-left:0;'>");
+        for (int i = 0; i < ix->sem_count[semester]; ++i) {
+            const char *name = db->subjects[ix->sem_subjects[semester][i]].title;
+            buf_puts(&b, "<li><label><input type='checkbox' name='subject' value=\"");
+            buf_put_html(&b, name);
+            buf_puts(&b, "\"/> ");
+            buf_put_html(&b, name);
+            buf_puts(&b, "</label></li>");
+        }
+        buf_puts(&b, "</ul><div style='margin-top:8px'><button>Open mark page</button></div></form><p><a href='/attendance'>Back</a></p></body></html>");
+    }
+    char *page = buf_finish(&b);
+    if (cacheable && page) {
+        attendance_subjects_cache[semester] = page;
+        attendance_subjects_version[semester] = db->subjects_version;
+        attendance_subjects_count[semester] = db->subject_count;
+    }
+    return page;
+}
+
+/* ---------- Attendance sessions ----------
+   Marking attendance is one session: a class held in the chosen subjects
+   for every student of the semester who takes one of them, attended by
+   those ticked. The mark form is paged like the roster, but a session is
+   submitted once. "Next page" posts the form back to /attendance-mark,
+   which carries the ticks made so far as hidden fields; only the last page
+   submits to /attendance, with every tick of the session, so the session
+   gets one report and one feed event however many pages it took. The
+   students a session covers are kept as one id-ordered list per process,
+   rebuilt when the roster version or the selection changes: a page costs
+   a binary search plus its rows, and its total is the list's length. */
+#define ATT_SUBJECTS MUT_SUBJECTS   /* subject rows one session marks */
+
+static struct {
+    unsigned long long version;
+    int indexed;                    /* student count it was built from, -1 = never */
+    int semester, nrows;
+    int rows[ATT_SUBJECTS];         /* the selection, as subject rows */
+    int n;
+    int slots[MAX_STUDENTS];        /* the session's students, by id */
+} att_set = { .indexed = -1 };
+
+/* the chosen titles as subject rows, this semester's row of a title first,
+   without repeats; how many (at most ATT_SUBJECTS) */
+static int attendance_subject_rows(int semester, const char **subjects, int subj_count, int *rows) {
+    const CoreIndex *ix = roster_index();
+    int n = 0;
+    for (int i = 0; i < subj_count && n < ATT_SUBJECTS; ++i) {
+        int r = core_subject_find(ix, db, subjects[i], semester);
+        if (r < 0) r = core_subject_find(ix, db, subjects[i], 0);
+        int k = 0;
+        while (k < n && rows[k] != r) ++k;
+        if (r >= 0 && k == n) rows[n++] = r;
+    }
+    return n;
+}
+
+/* the slots, in id order, of the semester's (1-8) students taking any of
+   the subject rows */
+static const int *attendance_students(int semester, const int *rows, int nrows, int *n) {
+    if (att_set.version != db->version || att_set.indexed != db->count || att_set.semester != semester ||
+        att_set.nrows != nrows || memcmp(att_set.rows, rows, (size_t)nrows * sizeof(int)) != 0) {
+        unsigned char selected[MAX_SUBJECTS] = {0};
+        for (int k = 0; k < nrows; ++k) selected[rows[k]] = 1;
+        int total;
+        const int *v = sorted_roster(semester, &total);
+        att_set.n = 0;
+        for (int k = 0; k < total; ++k) {
+            const Student *s = &db->students[v[k]];
+            const Enrollment *e = db->enrollments + s->first;
+            int j = 0;
+            while (j < s->num_subjects && !selected[e[j].subject]) ++j;
+            if (j < s->num_subjects) att_set.slots[att_set.n++] = v[k];
         }
+        att_set.version = db->version;
+        att_set.indexed = db->count;
+        att_set.semester = semester;
+        att_set.nrows = nrows;
+        memcpy(att_set.rows, rows, (size_t)nrows * sizeof(int));
     }
-    if (strlen(added) == 0) {
-        strncat(buf, "<p>No subjects found for that semester (no students in that semester).</p>", cap - strlen(buf) -1);
-        strncat(buf, "<p><a href='/attendance'>Back</a></p></form></body></html>", cap - strlen(buf) -1);
-        return buf;
-    }
-
-    char *copy = strdup(added);
-    char *line = strtok(copy, "\n");
-    int idx = 0;
-    strncat(buf, "<ul style='list-style:none;padding-left:0;'>", cap - strlen(buf) -1);
-    while (line) {
-        char esc[256]; html_escape_buf(line, esc, sizeof(esc));
-        char chk[512];
-        snprintf(chk, sizeof(chk), "<li><label><input type='checkbox' name='subject' value=\"%s\"/> %s</label></li>", esc, esc);
-        strncat(buf, chk, cap - strlen(buf) -1);
-        idx++;
-        line = strtok(NULL, "\n");
-    }
-    free(copy);
-    strncat(buf, "</ul><div style='margin-top:8px'><button>Open mark page</button></div></form><p><a href='/attendance'>Back</a></p></body></html>", cap - strlen(buf) -1);
-    return buf;
-}
-
-/* build attendance marking page: shows students who are in selected semester and selected subject(s) with checkboxes */
-static char *build_attendance_mark_page(int semester, char **subjects, int subj_count) {
-    size_t cap = 32768;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    snprintf(buf, cap, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Mark</title></head><body><h2>Mark Attendance - Step 3: Mark Present/Absent</h2><form method='post' action='/attendance'>");
+    *n = att_set.n;
+    return att_set.slots;
+}
+
+/* build attendance marking page: one page of the session's students, with
+   a present checkbox per selected subject. form is the request's; past the
+   first page it holds the ticks so far, which are carried along as checked
+   boxes for students on this page and hidden fields for the rest. */
+static char *build_attendance_mark_page(Arena *a, int semester, const char **subjects, int subj_count,
+                                        const PageReq *pg, const FormTable *form) {
+    int rows[ATT_SUBJECTS], n;
+    int nrows = attendance_subject_rows(semester, subjects, subj_count, rows);
+    const int *v = attendance_students(semester, rows, nrows, &n);
+    int pos = sorted_seek(v, n, pg->after);
+    int end = (n - pos > pg->limit) ? pos + pg->limit : n;
+    int lo = pos < end ? db->students[v[pos]].id : 0, hi = pos < end ? db->students[v[end - 1]].id : 0;
+
+    /* ticks so far, one bitset over roster slots per subject column */
+    int nwords = (db->count + 31) / 32 + 1;
+    unsigned int *ticked = arena_alloc(a, (size_t)(subj_count * nwords) * sizeof(unsigned int));
+    if (!ticked) return NULL;
+    memset(ticked, 0, (size_t)(subj_count * nwords) * sizeof(unsigned int));
+    for (int fi = 0; fi < form->nfields; ++fi) {
+        const FormField *f = &form->fields[fi];
+        int si = strncmp(f->key, "present_", 8) == 0 ? atoi(f->key + 8) : -1;
+        if (si < 0 || si >= subj_count) continue;
+        for (const FormValue *fv = f->first; fv; fv = fv->next) {
+            int slot = student_slot_by_id(atoi(fv->value));
+            if (slot >= 0) ticked[si * nwords + (slot >> 5)] |= 1u << (slot & 31);
+        }
+    }
+
+    Buf b = { .arena = a };
+    buf_puts(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance - Mark</title></head><body><h2>Mark Attendance - Step 3: Mark Present/Absent</h2><form method='post' action='/attendance'>");
     /* hidden semester */
-    char hsem[128]; snprintf(hsem, sizeof(hsem), "<input type='hidden' name='semester' value='%d'/>", semester);
-    strncat(buf, hsem, cap - strlen(buf) -1);
+    buf_printf(&b, "<input type='hidden' name='semester' value='%d'/><input type='hidden' name='limit' value='%d'/>",
+               semester, pg->limit);
     /* hidden subjects (multiple) */
     for (int i=0;i<subj_count;++i) {
-        char esc[256]; html_escape_buf(subjects[i], esc, sizeof(esc));
-        char hs[512]; snprintf(hs, sizeof(hs), "<input type='hidden' name='subject' value=\"%s\"/>", esc);
-        strncat(buf, hs, cap - strlen(buf) -1);
+        buf_puts(&b, "<input type='hidden' name='subject' value=\"");
+        buf_put_html(&b, subjects[i]);
+        buf_puts(&b, "\"/>");
     }
 
-    /* date */
-    time_t t = time(NULL); struct tm tm = *localtime(&t); char datebuf[32];
-    snprintf(datebuf, sizeof(datebuf), "%04d-%02d-%02d", tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday);
-    char dateinp[256]; snprintf(dateinp, sizeof(dateinp), "Date (YYYY-MM-DD): <input name='date' value='%s'/>", datebuf);
-    strncat(buf, dateinp, cap - strlen(buf) -1);
+    /* date, as given on the first page */
+    const char *date = form_get(form, "date");
+    buf_puts(&b, "Date (YYYY-MM-DD): <input name='date' value='");
+    if (date) buf_put_html(&b, date);
+    else {
+        time_t t = time(NULL); struct tm tm = *localtime(&t);
+        buf_printf(&b, "%04d-%02d-%02d", tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday);
+    }
+    buf_puts(&b, "'/>");
 
     /* table header */
-    strncat(buf, "<table border='1' cellpadding='6'><tr><th>Student ID</th><th>Name</th>", cap - strlen(buf) -1);
+    buf_puts(&b, "<table border='1' cellpadding='6'><tr><th>Student ID</th><th>Name</th>");
     for (int i=0;i<subj_count;++i) {
-        char esc[256]; html_escape_buf(subjects[i], esc, sizeof(esc));
-        char th[256]; snprintf(th, sizeof(th), "<th>%s (Present)</th>", esc);
-        strncat(buf, th, cap - strlen(buf) -1);
-    }
-    strncat(buf, "</tr>", cap - strlen(buf) -1);
-
-    int rows = 0;
-    for (int i=0;i<student_count;++i) {
-        if (!students[i].exists) continue;
-        if (students[i].current_semester != semester) continue;
-        /* check student has all selected subjects (or at least one) */
-        int has_any = 0;
-        for (int si=0; si<subj_count; ++si) {
-            for (int j=0;j<students[i].num_subjects;++j) {
-                if (strcmp(students[i].subjects[j].name, subjects[si])==0) { has_any = 1; break; }
-            }
-            if (has_any) break;
-        }
-        if (!has_any) continue;
-        /* build row */
-        char row[2048]; char cells[1024]; cells[0]=0;
+        buf_puts(&b, "<th>");
+        buf_put_html(&b, subjects[i]);
+        buf_puts(&b, " (Present)</th>");
+    }
+    buf_puts(&b, "</tr>");
+
+    for (int k = pos; k < end; ++k) {
+        const Student *s = &db->students[v[k]];
+        buf_printf(&b, "<tr><td>%d</td><td>", s->id);
+        buf_put_html(&b, s->name);
+        buf_puts(&b, "</td>");
         for (int si=0; si<subj_count; ++si) {
-            char cb[256]; snprintf(cb, sizeof(cb), "<td><input type='checkbox' name='present_%d' value='%d'/></td>", si, students[i].id);
-            strncat(cells, cb, sizeof(cells)-strlen(cells)-1);
+            int on = (ticked[si * nwords + (v[k] >> 5)] >> (v[k] & 31)) & 1;
+            buf_printf(&b, "<td><input type='checkbox' name='present_%d' value='%d'%s/></td>", si, s->id,
+                       on ? " checked" : "");
         }
-        snprintf(row, sizeof(row), "<tr><td>%d</td><td>%s</td>%s</tr>", students[i].id, students[i].name, cells);
-        if (strlen(buf) + strlen(row) + 256 > cap) { cap *= 2; buf = realloc(buf, cap); }
-        strcat(buf, row);
-        rows++;
+        buf_puts(&b, "</tr>");
     }
-    if (rows == 0) {
-        strncat(buf, "<tr><td colspan='10'>No students found for the selected semester/subjects.</td></tr>", cap - strlen(buf) -1);
+    if (pos == end) {
+        buf_puts(&b, "<tr><td colspan='10'>No students found for the selected semester/subjects.</td></tr>");
     }
-    strncat(buf, "</table><div style='margin-top:8px'><button>Mark Attendance</button></div></form><p><a href='/attendance'>Back</a></p></body></html>", cap - strlen(buf) -1);
-    return buf;
+    buf_puts(&b, "</table>");
+    /* ticks on other pages ride along */
+    for (int fi = 0; fi < form->nfields; ++fi) {
+        const FormField *f = &form->fields[fi];
+        int si = strncmp(f->key, "present_", 8) == 0 ? atoi(f->key + 8) : -1;
+        if (si < 0 || si >= subj_count) continue;
+        for (const FormValue *fv = f->first; fv; fv = fv->next) {
+            int id = atoi(fv->value);
+            if (id <= 0 || (id >= lo && id <= hi)) continue;
+            buf_printf(&b, "<input type='hidden' name='present_%d' value='%d'/>", si, id);
+        }
+    }
+    PageReq first = { 0, pg->limit };
+    buf_put_pager(&b, "", &first, pos, end - pos, n, 0);
+    if (end < n)
+        buf_printf(&b, "<div style='margin-top:8px'><button formaction='/attendance-mark' name='after' value='%d'>Next page</button></div></form>", hi);
+    else
+        buf_puts(&b, "<div style='margin-top:8px'><button>Mark Attendance</button></div></form>");
+    buf_puts(&b, "<p><a href='/attendance'>Back</a></p></body></html>");
+    return buf_finish(&b);
 }
 
 /* Build admin marks entry: first page ask for student id (or choose from list) */
-static char *build_marks_enter_id_page(const char *msg) {
-    size_t cap = 4096;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    strcpy(buf, "<!doctype html><html><head><meta charset='utf-8'><title>Enter Marks - Student</title></head><body><h2>Enter Marks - Step 1: Enter Student ID</h2>");
-    if (msg && msg[0]) { strncat(buf, "<p style='color:red;'>", cap - strlen(buf) -1); strncat(buf, msg, cap - strlen(buf) -1); strncat(buf, "</p>", cap - strlen(buf) -1); }
-    strcat(buf, "<form method='get' action='/enter-marks-student'>Student ID: <input name='id' required/> <button>Open</button></form>");
-    strcat(buf, "<h3>Or choose from list</h3><ul>");
-    for (int i=0;i<student_count;++i) {
-        if (!students[i].exists) continue;
-        char li[256]; snprintf(li, sizeof(li), "<li><a href='/enter-marks-student?id=%d'>%d - %s (sem %d)</a></li>", students[i].id, students[i].id, students[i].name, students[i].current_semester);
-        strncat(buf, li, cap - strlen(buf) -1);
-    }
-    strcat(buf, "</ul><p><a href='/'>Back</a></p></body></html>");
-    return buf;
+static char *build_marks_enter_id_page(Arena *a, const char *msg, const PageReq *pg) {
+    int n;
+    const int *v = sorted_roster(0, &n);
+    int pos = sorted_seek(v, n, pg->after);
+    int end = (n - pos > pg->limit) ? pos + pg->limit : n;
+    Buf b = { .arena = a };
+    buf_puts(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Enter Marks - Student</title></head><body><h2>Enter Marks - Step 1: Enter Student ID</h2>");
+    if (msg && msg[0]) { buf_puts(&b, "<p style='color:red;'>"); buf_put_html(&b, msg); buf_puts(&b, "</p>"); }
+    buf_puts(&b, "<form method='get' action='/enter-marks-student'>Student ID: <input name='id' required/> <button>Open</button></form>");
+    buf_puts(&b, "<h3>Or choose from list</h3><ul>");
+    for (int k = pos; k < end; ++k) {
+        const Student *s = &db->students[v[k]];
+        buf_printf(&b, "<li><a href='/enter-marks-student?id=%d'>%d - ", s->id, s->id);
+        buf_put_html(&b, s->name);
+        buf_printf(&b, " (sem %d)</a></li>", s->current_semester);
+    }
+    buf_puts(&b, "</ul>");
+    buf_put_pager(&b, "/enter-marks?", pg, pos, end - pos, n, end < n ? db->students[v[end - 1]].id : 0);
+    buf_puts(&b, "<p><a href='/'>Back</a></p></body></html>");
+    return buf_finish(&b);
 }
 
 /* Build marks entry page for a student: auto-selects current semester and shows only subjects from that semester */
-static char *build_marks_table_page_for_student(int sid, const char *msg) {
-    int idx = api_find_index_by_id(sid);
+static char *build_marks_table_page_for_student(Arena *a, int sid, const char *msg) {
+    int idx = student_slot_by_id(sid);
     if (idx == -1) return NULL;
-    Student *s = &students[idx];
-    size_t cap = 32768;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    snprintf(buf, cap, "<!doctype html><html><head><meta charset='utf-8'><title>Enter Marks for %d</title></head><body><h2>Enter Marks - %s (ID %d)</h2>", s->current_semester, s->name, s->id);
-    if (msg && msg[0]) { strncat(buf, "<p style='color:red;'>", cap - strlen(buf) -1); strncat(buf, msg, cap - strlen(buf) -1); strncat(buf, "</p>", cap - strlen(buf) -1); }
-    /* Build list of subjects that belong to student's current semester (approx by checking students in system) */
-    /* We'll include subjects that student has and that we can reasonably say belong to current semester (by matching their presence) */
-    /* For simplicity: include any subject that the student has whose name appears among subjects for other students in same current_semester OR simply where its semester inferred equals current_semester */
-    char subj_names[8192]; subj_names[0]=0;
-    for (int j=0;j<s->num_subjects;++j) {
-        /* include only if this subject appears as part of student's set and student's current_semester matches or it's one of the later semester subjects */
-        /* We'll simply pick subjects where a majority of students who have that subject are in same sem — but to keep it simple, include if s->current_semester matches student's own current_semester (always true) */
-        /* So show only subjects which the student has AND (we approximate semester match by checking if many students with this subject are in current_semester) */
-        int sem_count = 0, other_count=0;
-        for (int i=0;i<student_count;++i) {
-            if (!students[i].exists) continue;
-            for (int k=0;k<students[i].num_subjects;++k) {
-                if (strcmp(students[i].subjects[k].name, s->subjects[j].name)==0) {
-                    if (students[i].current_semester == s->current_semester) sem_count++;
-                    other_count++;
-                    break;
-                }
-            }
+    Student *s = &db->students[idx];
+    Buf b = { .arena = a };
+    buf_printf(&b, "<!doctype html><html><head><meta charset='utf-8'><title>Enter Marks for %d</title></head><body><h2>Enter Marks - ", s->current_semester);
+    buf_put_html(&b, s->name);
+    buf_printf(&b, " (ID %d)</h2>", s->id);
+    if (msg && msg[0]) { buf_puts(&b, "<p style='color:red;'>"); buf_put_html(&b, msg); buf_puts(&b, "</p>"); }
+    /* the student's subjects of the current semester */
+    const Enrollment *en = db->enrollments + s->first;
+    int picked[MAX_ENROLLED]; int npicked = 0;
+    for (int j=0;j<s->num_subjects;++j)
+        if (db->subjects[en[j].subject].semester == s->current_semester) picked[npicked++] = j;
+
+    if (npicked == 0) {
+        buf_puts(&b, "<p>No subjects found for the student's current semester. Showing all subjects instead.</p>");
+        for (int j=0;j<s->num_subjects;++j) picked[npicked++] = j;
+    }
+
+    /* form */
+    buf_printf(&b, "<form method='post' action='/enter-marks'><input type='hidden' name='id' value='%d'/>", s->id);
+    buf_puts(&b, "<table border='1' cellpadding='6'><tr><th>Subject</th><th>Marks (0-100)</th></tr>");
+    for (int p=0; p<npicked; ++p) {
+        const Enrollment *e = &en[picked[p]];
+        const SubjectRec *sub = &db->subjects[e->subject];
+        buf_puts(&b, "<tr><td>");
+        buf_put_html(&b, sub->title);
+        buf_puts(&b, "</td><td><input name='m_");
+        buf_put_html(&b, sub->id);
+        if (e->marks >= 0) buf_printf(&b, "' value='%d' /></td></tr>", e->marks);
+        else buf_puts(&b, "' value='' /></td></tr>");
+    }
+    buf_puts(&b, "</table><div style='margin-top:8px'><button>Submit Marks</button></div></form><p><a href='/admin'>Back</a></p></body></html>");
+    return buf_finish(&b);
+}
+
+/* ---------- JSON REST API (/api/v1) ----------
+   Read-only structured views for integrations (LMS sync, notice boards).
+   Callers authenticate with the admin credentials via HTTP Basic auth. */
+
+static int base64_value(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+/* decode base64 into out (NUL-terminated); returns decoded length or -1 */
+static int base64_decode(const char *in, size_t n, char *out, size_t outcap) {
+    size_t j = 0;
+    unsigned int acc = 0; int bits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (in[i] == '=') break;
+        int v = base64_value((unsigned char)in[i]);
+        if (v < 0) return -1;
+        acc = (acc << 6) | (unsigned int)v; bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (j + 1 >= outcap) return -1;
+            out[j++] = (char)((acc >> bits) & 0xff);
         }
-        /* include if sem_count >= other_count/2 (i.e. common in this semester), or if other_count==0 */
-        if (other_count == 0 || sem_count * 2 >= other_count) {
-            if (strlen(subj_names) + strlen(s->subjects[j].name) + 8 < sizeof(subj_names)) {
-                strcat(subj_names, s->subjects[j].name);
-                strcat(subj_names, "\n");
-            }
+    }
+    out[j] = 0;
+    return (int)j;
+}
+
+/* check "Authorization: Basic ..." in the request head against the admin account */
+static int api_request_authorized(const HttpRequest *rq) {
+    Slice h = http_header(rq, "Authorization");
+    if (h.n < 6 || strncasecmp(h.p, "Basic ", 6) != 0) return 0;
+    char cred[256];
+    if (base64_decode(h.p + 6, h.n - 6, cred, sizeof(cred)) < 0) return 0;
+    char *colon = strchr(cred, ':');
+    if (!colon) return 0;
+    *colon = 0;
+    return core_admin_auth(cred, colon + 1);
+}
+
+static void api_send_json(int client, const char *status, Buf *b) {
+    if (b->oom) { send_text(client, "500 Internal Server Error", "application/json", "{\"error\":\"out of memory\"}"); return; }
+    send_response(client, status, "application/json; charset=utf-8", b->data ? b->data : "", b->len);
+}
+
+static void api_send_error(int client, Arena *a, const char *status, const char *msg) {
+    Buf b = { .arena = a };
+    JsonWriter w; json_init(&w, &b);
+    json_obj_begin(&w);
+    json_key(&w, "error"); json_str(&w, msg);
+    json_obj_end(&w);
+    api_send_json(client, status, &b);
+}
+
+static void api_write_student_fields(JsonWriter *w, const Student *s) {
+    json_key(w, "id"); json_int(w, s->id);
+    json_key(w, "name"); json_str(w, s->name);
+    json_key(w, "email"); json_str(w, s->email);
+    json_key(w, "phone"); json_str(w, s->phone);
+    json_key(w, "dept"); json_str(w, s->dept);
+    json_key(w, "age"); json_int(w, s->age);
+    json_key(w, "year"); json_int(w, s->year);
+    json_key(w, "current_semester"); json_int(w, s->current_semester);
+}
+
+static void api_write_subjects(JsonWriter *w, int slot, int with_marks, int with_att) {
+    const Student *s = &db->students[slot];
+    const Enrollment *en = db->enrollments + s->first;
+    json_arr_begin(w);
+    for (int i = 0; i < s->num_subjects; ++i) {
+        const Enrollment *e = &en[i];
+        const SubjectRec *sub = &db->subjects[e->subject];
+        json_obj_begin(w);
+        json_key(w, "subject"); json_str(w, sub->title);
+        json_key(w, "semester"); if (sub->semester > 0) json_int(w, sub->semester); else json_null(w);
+        json_key(w, "credits"); json_int(w, sub->credits);
+        if (with_marks) {
+            json_key(w, "marks"); if (e->marks >= 0) json_int(w, e->marks); else json_null(w);
+            json_key(w, "grade_point"); if (e->marks >= 0) json_int(w, core_grade_point(e->marks)); else json_null(w);
+        }
+        if (with_att) {
+            json_key(w, "classes_held"); json_int(w, e->held);
+            json_key(w, "classes_attended"); json_int(w, e->attended);
+            json_key(w, "attendance_pct");
+            if (e->held > 0) json_num(w, (double)e->attended * 100.0 / e->held);
+            else json_null(w);
         }
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+}
+
+/* a grade point average, null when nothing counted is graded */
+static void api_write_gpa_value(JsonWriter *w, double gpa) {
+    if (gpa < 0) json_null(w);
+    else json_num(w, gpa);
+}
+
+static void api_write_gpa(JsonWriter *w, int slot) {
+    const Student *s = &db->students[slot];
+    const Enrollment *en = db->enrollments + s->first;
+    json_obj_begin(w);
+    json_key(w, "sgpa");
+    json_arr_begin(w);
+    for (int sem = 1; sem <= 8; ++sem) {
+        int taken = 0, credits = 0;
+        for (int i = 0; i < s->num_subjects; ++i) taken |= db->subjects[en[i].subject].semester == sem;
+        if (!taken) continue;
+        double gpa = core_gpa(db, slot, sem, &credits);
+        json_obj_begin(w);
+        json_key(w, "semester"); json_int(w, sem);
+        json_key(w, "credits"); json_int(w, credits);
+        json_key(w, "sgpa"); api_write_gpa_value(w, gpa);
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+    int credits;
+    double cgpa = core_gpa(db, slot, 0, &credits);
+    json_key(w, "cgpa"); api_write_gpa_value(w, cgpa);
+    json_key(w, "stored_cgpa"); json_num(w, s->cgpa);
+    json_key(w, "credits_completed"); json_int(w, credits);
+    json_obj_end(w);
+}
+
+/* GET /api/v1/students */
+static void api_students_list(int client, Arena *a) {
+    Buf b = { .arena = a };
+    JsonWriter w; json_init(&w, &b);
+    int n = 0;
+    json_obj_begin(&w);
+    json_key(&w, "students");
+    json_arr_begin(&w);
+    for (int i = 0; i < db->count; ++i) {
+        if (!db->students[i].exists) continue;
+        json_obj_begin(&w);
+        api_write_student_fields(&w, &db->students[i]);
+        json_key(&w, "cgpa"); json_num(&w, db->students[i].cgpa);
+        json_obj_end(&w);
+        n++;
     }
+    json_arr_end(&w);
+    json_key(&w, "count"); json_int(&w, n);
+    json_obj_end(&w);
+    api_send_json(client, "200 OK", &b);
+}
 
-    if (strlen(subj_names) == 0) {
-        strncat(buf, "<p>No subjects found for the student's current semester. Showing all subjects instead.</p>", cap - strlen(buf) -1);
-        for (int j=0;j<s->num_subjects;++j) {
-            strncat(subj_names, s->subjects[j].name, sizeof(subj_names)-strlen(subj_names)-1);
-            strncat(subj_names, "\n", sizeof(subj_names)-strlen(subj_names)-1);
+/* GET /api/v1/subjects[?semester=N] */
+static void api_subjects_list(int client, Arena *a, int only_sem) {
+    Buf b = { .arena = a };
+    JsonWriter w; json_init(&w, &b);
+    json_obj_begin(&w);
+    json_key(&w, "subjects");
+    json_arr_begin(&w);
+    for (int sem = 1; sem <= 8; ++sem) {
+        if (only_sem && sem != only_sem) continue;
+        const CoreIndex *ix = roster_index();
+        for (int i = 0; i < ix->sem_count[sem]; ++i) {
+            const SubjectRec *c = &db->subjects[ix->sem_subjects[sem][i]];
+            json_obj_begin(&w);
+            json_key(&w, "id"); json_str(&w, c->id);
+            json_key(&w, "name"); json_str(&w, c->title);
+            json_key(&w, "semester"); json_int(&w, sem);
+            json_key(&w, "credits"); json_int(&w, c->credits);
+            json_obj_end(&w);
         }
     }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    api_send_json(client, "200 OK", &b);
+}
 
-    /* form */
-    strncat(buf, "<form method='post' action='/enter-marks'><input type='hidden' name='id' value='", cap - strlen(buf) -1);
-    char idbuf[64]; snprintf(idbuf, sizeof(idbuf), "%d", s->id);
-    strncat(buf, idbuf, cap - strlen(buf) -1);
-    strncat(buf, "'/>", cap - strlen(buf) -1);
-
-    strncat(buf, "<table border='1' cellpadding='6'><tr><th>Subject</th><th>Marks (0-100)</th></tr>", cap - strlen(buf) -1);
-    char *c = strdup(subj_names);
-    char *line = strtok(c, "\n");
-    while (line) {
-        /* find current marks for subject */
-        int mk = 0;
-        for (int j=0;j<s->num_subjects;++j) if (strcmp(s->subjects[j].name, line)==0) { mk = s->subjects[j].marks; break; }
-        char esc[256]; html_escape_buf(line, esc, sizeof(esc));
-        char row[512]; snprintf(row, sizeof(row), "<tr><td>%s</td><td><input name='m_%s' value='%d' /></td></tr>", esc, esc, mk);
-        if (strlen(buf) + strlen(row) + 256 > cap) { cap *= 2; buf = realloc(buf, cap); }
-        strcat(buf, row);
-        line = strtok(NULL, "\n");
-    }
-    free(c);
-    strncat(buf, "</table><div style='margin-top:8px'><button>Submit Marks</button></div></form><p><a href='/admin'>Back</a></p></body></html>", cap - strlen(buf) -1);
-    return buf;
-}
-
-/* handle a client connection */
-static void handle_client(int client) {
-    char req[REQBUF];
-    int r = read_request(client, req, sizeof(req));
-    if (r <= 0) { close(client); return; }
-
-    char method[8] = {0}, fullpath[1024] = {0}, proto[32] = {0};
-    sscanf(req, "%7s %1023s %31s", method, fullpath, proto);
-
-    /* separate path and query */
-    char path[1024]; strcpy(path, fullpath);
-    char *qmark = strchr(path, '?');
-    if (qmark) *qmark = 0;
-
-    /* GET handlers */
-    if (strcmp(method, "GET") == 0) {
-        if (strncmp(path, "/reports/", 9) == 0) {
-            const char *fname = path + 9;
-            while (*fname == '/') fname++;
-            serve_report_file(client, fname);
-            close(client); return;
+/* GET /api/v1/students/<id>[/marks|/attendance|/gpa] */
+static void api_student_detail(int client, Arena *a, int idx, const char *view) {
+    const Student *s = &db->students[idx];
+
+    Buf b = { .arena = a };
+    JsonWriter w; json_init(&w, &b);
+    if (view[0] == 0) {
+        json_obj_begin(&w);
+        api_write_student_fields(&w, s);
+        json_key(&w, "subjects"); api_write_subjects(&w, idx, 1, 1);
+        json_key(&w, "gpa"); api_write_gpa(&w, idx);
+        json_obj_end(&w);
+    } else if (strcmp(view, "/marks") == 0) {
+        json_obj_begin(&w);
+        json_key(&w, "id"); json_int(&w, s->id);
+        json_key(&w, "marks"); api_write_subjects(&w, idx, 1, 0);
+        json_obj_end(&w);
+    } else if (strcmp(view, "/attendance") == 0) {
+        json_obj_begin(&w);
+        json_key(&w, "id"); json_int(&w, s->id);
+        json_key(&w, "attendance"); api_write_subjects(&w, idx, 0, 1);
+        json_obj_end(&w);
+    } else if (strcmp(view, "/gpa") == 0) {
+        api_write_gpa(&w, idx);
+    } else {
+        api_send_error(client, a, "404 Not Found", "unknown resource");
+        return;
+    }
+    api_send_json(client, "200 OK", &b);
+}
+
+static void api_send_unauthorized(int client) {
+    const char *hdr =
+        "HTTP/1.1 401 Unauthorized\r\nContent-Type: application/json\r\n"
+        "WWW-Authenticate: Basic realm=\"student-system\"\r\nContent-Length: 24\r\nConnection: close\r\n\r\n"
+        "{\"error\":\"unauthorized\"}";
+    conn_send(client, hdr, strlen(hdr));
+}
+
+/* dispatch for everything under /api/v1 (path has the query already stripped) */
+static void handle_api(int client, Arena *a, const HttpRequest *rq, const char *method, const char *path, const FormTable *form) {
+    if (!api_request_authorized(rq)) { api_send_unauthorized(client); return; }
+    if (strcmp(method, "GET") != 0) { api_send_error(client, a, "405 Method Not Allowed", "read-only API"); return; }
+
+    const char *rest = path + strlen("/api/v1");
+    if (strcmp(rest, "/students") == 0) { api_students_list(client, a); return; }
+    if (strcmp(rest, "/subjects") == 0) {
+        const char *v = form_get(form, "semester");
+        int sem = v ? atoi(v) : 0;
+        if (sem < 0 || sem > 8) { api_send_error(client, a, "400 Bad Request", "semester must be 1-8"); return; }
+        api_subjects_list(client, a, sem);
+        return;
+    }
+    if (strncmp(rest, "/students/", 10) == 0) {
+        char *end = NULL;
+        long id = strtol(rest + 10, &end, 10);
+        if (end == rest + 10 || id <= 0) { api_send_error(client, a, "400 Bad Request", "invalid student id"); return; }
+        int idx = student_slot_by_id((int)id);
+        if (idx < 0) { api_send_error(client, a, "404 Not Found", "student not found"); return; }
+        api_student_detail(client, a, idx, end);
+        return;
+    }
+    api_send_error(client, a, "404 Not Found", "unknown resource");
+}
+
+/* ---------- Routing ----------
+   Routes are compiled at startup into the byte trie of student_http.c,
+   with one handler slot per method, so dispatch is a single walk over the
+   path. Handlers queue the response with send_*; the event loop writes it
+   out and closes the connection. */
+/* GET /reports/<file> */
+static void route_report(const RouteCtx *rc) {
+    const char *fname = rc->param;
+    while (*fname == '/') fname++;
+    serve_report_file(rc->client, rc->arena, fname);
+}
+
+/* GET /static/<asset> */
+static void route_static(const RouteCtx *rc) {
+    serve_static(rc->client, rc->rq, rc->param);
+}
+
+/* GET /events: subscribe to the change feed, optionally only what concerns
+   one student (?student=<id>, which also narrows to their semester) or one
+   semester (?semester=<n>). Events carry students' marks, so a student's
+   own feed needs their session, and any wider one (every student, or a
+   whole semester) admin auth. */
+static void route_events(const RouteCtx *rc) {
+    Conn *c = conn_by_fd[rc->client];
+    if (sse_count >= max_conns / 4) { send_overloaded(rc->client); return; }
+    const char *v = form_get(rc->form, "student");
+    int student = v ? atoi(v) : 0, semester = 0;
+    char tok[SESSION_TOKEN_LEN + 1];
+    int sid = 0;
+    if ((student <= 0 || session_find(&store->sessions, session_cookie(rc->rq, tok), &sid) < 0 || sid != student) &&
+        !api_request_authorized(rc->rq)) {
+        api_send_unauthorized(rc->client);
+        return;
+    }
+    if (student > 0) {
+        int idx = student_slot_by_id(student);
+        if (idx < 0) { send_text(rc->client, "404 Not Found", "text/plain", "Student not found"); return; }
+        semester = db->students[idx].current_semester;
+    }
+    v = form_get(rc->form, "semester");
+    if (v && atoi(v) >= 1 && atoi(v) <= 8) semester = atoi(v);
+    c->sub_student = student > 0 ? student : 0;
+    c->sub_semester = semester;
+    static const char head[] =
+        "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+        "X-Accel-Buffering: no\r\nConnection: keep-alive\r\n\r\nretry: 3000\n\n";
+    conn_send(rc->client, head, sizeof(head) - 1);
+    Slice last = http_header(rc->rq, "Last-Event-ID");
+    if (last.p) {
+        char idbuf[24];
+        slice_copy(last, idbuf, sizeof(idbuf));
+        sse_replay(c, strtoull(idbuf, NULL, 10));
+    }
+    c->stream = 1;
+}
+
+/* GET / */
+static void route_landing(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    char *page = build_landing_page(arena);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* GET /list */
+static void route_list(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    PageReq pg = page_request(rc->form);
+    char *page = build_list_html(arena, &pg);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* check a student's credentials, start a session and send them on to
+   /dashboard with its cookie */
+static void student_sign_in(int client, const char *idv, const char *pass) {
+    int id = idv ? atoi(idv) : -1;
+    if (id <= 0 || !pass || pass[0]==0) {
+        send_text(client, "400 Bad Request", "text/plain", "Missing id or pass (use the sign-in form).");
+        return;
+    }
+    int idx = student_slot_by_id(id);
+    if (idx == -1) { send_text(client, "404 Not Found", "text/plain", "Student not found"); return; }
+    if (strcmp(pass, db->students[idx].password) != 0) { send_text(client, "401 Unauthorized", "text/plain", "Wrong password"); return; }
+    char token[SESSION_TOKEN_LEN + 1];
+    if (session_create(&store->sessions, id, token) < 0) { send_text(client, "503 Service Unavailable", "text/plain", "Too many sessions"); return; }
+    char extra[256];
+    snprintf(extra, sizeof(extra),
+             "Location: /dashboard\r\nSet-Cookie: sid=%s; Path=/; Max-Age=%d; HttpOnly; SameSite=Lax\r\n",
+             token, SESSION_TTL_S);
+    send_response_headers(client, "303 See Other", "text/plain", extra, "Signed in", 9);
+}
+
+/* POST /login: id and pass */
+static void route_login(const RouteCtx *rc) {
+    student_sign_in(rc->client, form_get(rc->form, "id"), form_get(rc->form, "pass"));
+}
+
+/* POST /logout */
+static void route_logout(const RouteCtx *rc) {
+    char tok[SESSION_TOKEN_LEN + 1];
+    session_end(&store->sessions, session_cookie(rc->rq, tok));
+    send_response_headers(rc->client, "303 See Other", "text/plain",
+                          "Location: /\r\nSet-Cookie: sid=; Path=/; Max-Age=0; HttpOnly; SameSite=Lax\r\n",
+                          "Signed out", 10);
+}
+
+/* dashboard of the signed-in student; an old-style ?id=&pass= link signs
+   in first so the credentials drop out of the URL */
+static void route_dashboard(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    const char *pass = form_get(form, "pass");
+    if (pass) { student_sign_in(client, form_get(form, "id"), pass); return; }
+    char tok[SESSION_TOKEN_LEN + 1];
+    int sid, idx = -1;
+    if (session_find(&store->sessions, session_cookie(rc->rq, tok), &sid) >= 0) idx = student_slot_by_id(sid);
+    if (idx == -1) {
+        send_response_headers(client, "303 See Other", "text/plain", "Location: /\r\n", "Please sign in", 14);
+        return;
+    }
+    char *page = build_student_dashboard(arena, idx);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* Attendance: Step 1 - choose semester */
+static void route_attendance_start(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    /* a semester in the query skips straight to the subject picker */
+    const char *sem = form_get(form, "semester");
+    if (sem && sem[0]) {
+        char loc[96];
+        snprintf(loc, sizeof(loc), "Location: /attendance-subjects?semester=%d\r\n", atoi(sem));
+        send_response_headers(client, "302 Found", "text/plain", loc, "Redirecting", 11);
+        return;
+    }
+    char *page = build_attendance_sem_select_page(arena);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* Attendance: Step 2 - choose subjects of a semester */
+static void route_attendance_subjects(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    const char *sem = form_get(form, "semester");
+    int semester = sem ? atoi(sem) : 0;
+    if (semester < 1 || semester > 8) {
+        char *page = build_attendance_sem_select_page(arena);
+        if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+        else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+        return;
+    }
+    char *page = build_attendance_subjects_page(arena, semester, NULL);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* Attendance: Step 3 - tick the present students */
+static void route_attendance_mark_page(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    /* semester and repeated subject values */
+    const char *sem = form_get(form, "semester");
+    int semester = sem ? atoi(sem) : 0;
+    const char *subjects[64]; int subj_count=0;
+    const FormField *sf = form_field(form, "subject");
+    for (const FormValue *fv = sf ? sf->first : NULL; fv && subj_count < 64; fv = fv->next)
+        subjects[subj_count++] = fv->value;
+    if (semester < 1 || semester > 8 || subj_count==0) {
+        /* redirect to semester select */
+        char *page = build_attendance_sem_select_page(arena);
+        if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+        else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+        return;
+    }
+    PageReq pg = page_request(form);
+    char *page = build_attendance_mark_page(arena, semester, subjects, subj_count, &pg, form);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* marks entry: Step 1 page to input student id */
+static void route_marks_id_page(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    /* show ID entry page */
+    PageReq pg = page_request(rc->form);
+    char *page = build_marks_enter_id_page(arena, NULL, &pg);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* marks entry: show student marks table when id provided as query (route /enter-marks-student?id=) */
+static void route_marks_student_page(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    const char *v = form_get(form, "id");
+    int sid = v ? atoi(v) : 0;
+    if (sid <= 0) {
+        PageReq pg = page_request(NULL);
+        char *page = build_marks_enter_id_page(arena, "Please provide a valid student ID.", &pg);
+        if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+        else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+        return;
+    }
+    if (student_slot_by_id(sid) == -1) { send_text(client, "404 Not Found", "text/plain", "Student not found"); return; }
+    char *page = build_marks_table_page_for_student(arena, sid, NULL);
+    if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
+    else { send_text(client, "200 OK", "text/html; charset=utf-8", page); }
+}
+
+/* Admin login */
+static void route_admin_login(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    const char *user = form_get(form, "username");
+    const char *pass = form_get(form, "password");
+    if (!user || !pass) {
+        send_text(client, "400 Bad Request", "text/plain", "Missing username or password");
+        return;
+    }
+    int ok = core_admin_auth(user, pass);
+    if (!ok) { send_text(client, "401 Unauthorized", "text/plain", "Invalid admin credentials"); return; }
+    /* admin dashboard with new flows */
+    const char *adm =
+      "<!doctype html><html><head><meta charset='utf-8'><title>Admin Dashboard</title>"
+      "<link rel='stylesheet' href='%s'/></head><body class='admin'>"
+      "<div class='card'><h2>Admin Dashboard</h2>"
+      "<p>Manage marks and attendance.</p>"
+      "<h3>View all students</h3><p><a href='/list'>Open students list</a></p>"
+      "<h3>Enter marks for a student</h3>"
+      "<p><a href='/enter-marks'>Enter marks (open by student ID)</a></p>"
+      "<h3>Mark attendance</h3>"
+      "<p><a href='/attendance'>Start attendance flow (select semester → subject → mark)</a></p>"
+      "<p><a href='/'>Back</a></p></div></body></html>";
+    Buf b = { .arena = arena };
+    buf_printf(&b, adm, static_url(ASSET_SITE_CSS));
+    send_text(client, "200 OK", "text/html; charset=utf-8", buf_finish(&b));
+}
+
+/* Student sign-up */
+/* ctx: the id asked for and the semester; addres: the applier's result */
+static void signup_done(int client, Arena *a, void *ctx, int addres) {
+    (void)a;
+    const int *asked = ctx;
+    if (addres == -2) {
+        char resp[256];
+        snprintf(resp, sizeof(resp),
+            "<!doctype html><html><body><p>SAP ID %d already registered. Try signing in.</p><p><a href='/'>Back</a></p></body></html>",
+            asked[0]);
+        send_text(client, "409 Conflict", "text/html; charset=utf-8", resp);
+    } else if (addres <= 0) {
+        send_text(client, "500 Internal Server Error", "text/plain", "Unable to register");
+    } else {
+        char resp[512];
+        snprintf(resp, sizeof(resp),
+            "<!doctype html><html><body><p>Registration successful!</p>"
+            "<p>Your Student ID (SAP ID): <strong>%d</strong></p>"
+            "<p>Default subjects for semester %d and earlier have been added automatically.</p>"
+            "<p><a href='/'>Back to Home</a></p></body></html>", addres, asked[1]);
+        send_text(client, "200 OK", "text/html; charset=utf-8", resp);
+    }
+}
+
+static void route_student_signup(const RouteCtx *rc) {
+    int client = rc->client;
+    const FormTable *form = rc->form;
+    const char *name = form_get(form, "name");
+    const char *age = form_get(form, "age");
+    const char *sap = form_get(form, "sap_id");
+    const char *password = form_get(form, "password");
+    const char *email = form_get(form, "email");
+    const char *phone = form_get(form, "phone");
+    const char *semester = form_get(form, "semester");
+    if (!name || !age || !sap || !password || !email || !phone || !semester) {
+        send_text(client, "400 Bad Request", "text/plain", "Missing fields");
+        return;
+    }
+    int sapid = atoi(sap);
+    int sem = atoi(semester);
+    if (sapid <= 0 || sem < 1 || sem > 8) {
+        char resp[256];
+        snprintf(resp, sizeof(resp),
+            "<!doctype html><html><body><p>Invalid SAP ID or semester provided.</p><p><a href='/'>Back</a></p></body></html>");
+        send_text(client, "400 Bad Request", "text/html; charset=utf-8", resp);
+        return;
+    }
+    Student s; memset(&s, 0, sizeof(s));
+    s.id = sapid;
+    snprintf(s.roll, sizeof(s.roll), "%d", sapid);
+    strncpy(s.name, name, sizeof(s.name)-1); s.name[sizeof(s.name)-1]=0;
+    s.age = (unsigned char)(atoi(age) < 0 ? 0 : atoi(age) > 255 ? 255 : atoi(age));
+    strncpy(s.email, email, sizeof(s.email)-1); s.email[sizeof(s.email)-1]=0;
+    strncpy(s.phone, phone, sizeof(s.phone)-1); s.phone[sizeof(s.phone)-1]=0;
+    strncpy(s.dept, "B.Tech CSE", sizeof(s.dept)-1); s.dept[sizeof(s.dept)-1]=0;
+    s.year = 1;
+    s.current_semester = sem;
+    strncpy(s.password, password, sizeof(s.password)-1); s.password[sizeof(s.password)-1]=0;
+
+    /* the applier adds the subject rows of semesters 1..sem as enrollments */
+    Mutation cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.op = MUT_REGISTER;
+    cmd.u.reg = s;
+    int *ctx = arena_alloc(rc->arena, 2 * sizeof(int));
+    if (!ctx) { send_text(client, "500 Internal Server Error", "text/plain", "Out of memory"); return; }
+    ctx[0] = s.id;
+    ctx[1] = sem;
+    unsigned int first = mut_begin();
+    mut_reply_later(client, first, mut_push(&cmd), signup_done, ctx);
+}
+
+/* the student's enrollment a marks field names: m_<subject id>, or the
+   subject title as older forms and scripts send it (current semester first) */
+static Enrollment *marks_field_enrollment(int slot, const char *name) {
+    const Student *s = &db->students[slot];
+    Enrollment *e = db->enrollments + s->first, *by_title = NULL;
+    for (int i = 0; i < s->num_subjects; ++i) {
+        const SubjectRec *sub = &db->subjects[e[i].subject];
+        if (strcmp(sub->id, name) == 0) return &e[i];
+        if (strcmp(sub->title, name) == 0 && (!by_title || sub->semester == s->current_semester)) by_title = &e[i];
+    }
+    return by_title;
+}
+
+/* Enter marks (admin) - POST endpoint /enter-marks */
+/* ctx: the student's id; updated: enrollments whose marks were set */
+static void marks_done(int client, Arena *a, void *ctx, int updated) {
+    (void)a;
+    char resp[256];
+    snprintf(resp, sizeof(resp), "<p>Marks updated for ID %d (%d subjects updated). <a href='/admin'>Back</a></p>",
+             *(const int *)ctx, updated);
+    send_text(client, "200 OK", "text/html; charset=utf-8", resp);
+}
+
+static void route_marks_submit(const RouteCtx *rc) {
+    int client = rc->client;
+    const FormTable *form = rc->form;
+    /* body contains fields id and many m_<subject>=<marks> entries */
+    const char *id_s = form_get(form, "id");
+    if (!id_s) {
+        send_text(client, "400 Bad Request", "text/plain", "Missing id");
+        return;
+    }
+    int sid = atoi(id_s);
+    int idx = student_slot_by_id(sid);
+    if (idx == -1) {
+        send_text(client, "404 Not Found", "text/plain", "Student not found");
+        return;
+    }
+    const Student *s = &db->students[idx];
+    /* every non-empty m_<subject> field carries the marks for that subject,
+       queued by subject id, MUT_SUBJECTS to a command; the titles go out on
+       the change feed as long as they fit one event */
+    Buf ev = { .arena = rc->arena };
+    JsonWriter jw; json_init(&jw, &ev);
+    json_obj_begin(&jw);
+    json_key(&jw, "student"); json_int(&jw, sid);
+    json_key(&jw, "subjects"); json_arr_begin(&jw);
+    Mutation cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.op = MUT_MARKS;
+    cmd.u.m.student = sid;
+    unsigned int first = mut_begin(), ticket = 0;
+    int named = 0;
+    for (int fi = 0; fi < form->nfields; ++fi) {
+        const FormField *f = &form->fields[fi];
+        if (strncmp(f->key, "m_", 2) != 0) continue;
+        if (!f->first->value[0]) continue;
+        const Enrollment *e = marks_field_enrollment(idx, f->key + 2);
+        if (!e) continue;
+        int mk = atoi(f->first->value);
+        if (mk < 0) mk = 0;
+        if (mk > 100) mk = 100;
+        const SubjectRec *sub = &db->subjects[e->subject];
+        if (cmd.nsubjects == MUT_SUBJECTS) { ticket = mut_push(&cmd); cmd.nsubjects = 0; }
+        memcpy(cmd.subjects[cmd.nsubjects], sub->id, MAX_SUBID);
+        cmd.u.m.marks[cmd.nsubjects++] = (short)mk;
+        if (ev.len + strlen(sub->title) + 24 < FEED_DATA_MAX) json_str(&jw, sub->title);
+        named++;
+    }
+    json_arr_end(&jw);
+    json_key(&jw, "updated"); json_int(&jw, named);
+    json_obj_end(&jw);
+    char *evdata = buf_finish(&ev);
+    if (evdata && ev.len < FEED_DATA_MAX) {
+        snprintf(cmd.event.type, sizeof(cmd.event.type), "marks");
+        cmd.event.student = sid;
+        cmd.event.semester = s->current_semester;
+        snprintf(cmd.event.data, sizeof(cmd.event.data), "%s", evdata);
+    }
+    if (cmd.nsubjects || cmd.event.type[0]) ticket = mut_push(&cmd);
+    int *ctx = arena_alloc(rc->arena, sizeof(int));
+    if (!ctx) { send_text(client, "500 Internal Server Error", "text/plain", "Out of memory"); return; }
+    *ctx = sid;
+    if (ticket) mut_reply_later(client, first, ticket, marks_done, ctx);
+    else marks_done(client, rc->arena, ctx, 0);
+}
+
+/* Attendance POST (admin) - POST to /attendance (from build_attendance_mark_page) */
+/* ctx: the report's file name; processed: enrollments that had a class added */
+static void attendance_done(int client, Arena *a, void *ctx, int processed) {
+    const char *fname = ctx;
+    Buf b = { .arena = a };
+    buf_printf(&b, "<p>Attendance marked (processed %d items). Report: <a href='/reports/%s'>%s</a>. <a href='/admin'>Back</a></p>", processed, fname, fname);
+    char *body = buf_finish(&b);
+    if (!body) { send_text(client, "500 Internal Server Error", "text/plain", "Out of memory"); return; }
+    send_text(client, "200 OK", "text/html; charset=utf-8", body);
+}
+
+static void route_attendance_submit(const RouteCtx *rc) {
+    int client = rc->client;
+    Arena *arena = rc->arena;
+    const FormTable *form = rc->form;
+    /* parse semester and subject hidden fields + date + present_N fields */
+    const char *sem_s = form_get(form, "semester");
+    if (!sem_s) { send_text(client, "400 Bad Request", "text/plain", "Missing semester"); return; }
+    int semester = atoi(sem_s);
+    if (semester < 1 || semester > 8) { send_text(client, "400 Bad Request", "text/plain", "Invalid semester"); return; }
+    /* hidden 'subject' fields - there may be multiple */
+    const char *subjects[64]; int subj_count=0;
+    const FormField *sf = form_field(form, "subject");
+    for (const FormValue *fv = sf ? sf->first : NULL; fv && subj_count < 64; fv = fv->next)
+        subjects[subj_count++] = fv->value;
+    /* the selected titles as subject rows, as the mark form had them */
+    int subject_rows[ATT_SUBJECTS];
+    int nsel = attendance_subject_rows(semester, subjects, subj_count, subject_rows);
+    Mutation cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.op = MUT_ATTENDANCE;
+    for (int k = 0; k < nsel; ++k) memcpy(cmd.subjects[cmd.nsubjects++], db->subjects[subject_rows[k]].id, MAX_SUBID);
+    /* present_<n> checkboxes: each value is a present student's id,
+       decoded into a bitset over roster slots */
+    int nwords = (db->count + 31) / 32;
+    unsigned int *present = arena_alloc(arena, (size_t)(nwords ? nwords : 1) * sizeof(unsigned int));
+    memset(present, 0, (size_t)(nwords ? nwords : 1) * sizeof(unsigned int));
+    for (int fi = 0; fi < form->nfields; ++fi) {
+        const FormField *f = &form->fields[fi];
+        if (strncmp(f->key, "present_", 8) != 0) continue;
+        for (const FormValue *fv = f->first; fv; fv = fv->next) {
+            int slot = student_slot_by_id(atoi(fv->value));
+            if (slot >= 0) present[slot >> 5] |= 1u << (slot & 31);
         }
-        if (strcmp(path, "/") == 0) {
-            char *page = build_landing_page();
-            if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
-            else { send_text(client, "200 OK", "text/html; charset=utf-8", page); free(page); }
-            close(client); return;
+    }
+    /* the session's students (every page of the form) each get a class held
+       in the selected subjects they take, and attended if present. Those
+       slots are the report rows; the applier does the counting,
+       MUT_STUDENTS students to a command. */
+    int nrows;
+    const int *rows = attendance_students(semester, subject_rows, nsel, &nrows);
+    /* write a small attendance report file */
+    ensure_reports_dir();
+    time_t t = time(NULL); struct tm tm = *localtime(&t);
+    char datebuf[64];
+    snprintf(datebuf, sizeof(datebuf), "%04d-%02d-%02d", tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday);
+    char fname[256];
+    /* slugify first subject only to create filename */
+    char subslug[128]; slugify(subj_count ? subjects[0] : "attendance", subslug, sizeof(subslug));
+    snprintf(fname, sizeof(fname), "attendance_%d_%s_%s.html", semester, datebuf, subslug);
+    char fpath[PATH_MAX]; snprintf(fpath, sizeof(fpath), "reports/%s", fname);
+    FILE *f = fopen(fpath, "w");
+    if (f) {
+        fprintf(f, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance</title></head><body>");
+        fprintf(f, "<h2>Attendance - Semester %d - %s</h2><table border='1' cellpadding='6'><tr><th>ID</th><th>Name</th>", semester, datebuf);
+        Buf row = { .arena = arena };   /* one table row, names and titles escaped */
+        for (int sj=0; sj<subj_count; ++sj) { buf_puts(&row, "<th>"); buf_put_html(&row, subjects[sj]); buf_puts(&row, "</th>"); }
+        buf_puts(&row, "</tr>");
+        if (!row.oom) fwrite(row.data, 1, row.len, f);
+        for (int r=0; r<nrows && !row.oom; ++r) {
+            int i = rows[r];
+            int is_present = (present[i >> 5] >> (i & 31)) & 1;
+            row.len = 0;
+            buf_printf(&row, "<tr><td>%d</td><td>", db->students[i].id);
+            buf_put_html(&row, db->students[i].name);
+            buf_puts(&row, "</td>");
+            for (int sj=0; sj<subj_count; ++sj) buf_printf(&row, "<td>%s</td>", is_present ? "Yes" : "No");
+            buf_puts(&row, "</tr>");
+            if (!row.oom) fwrite(row.data, 1, row.len, f);
         }
-        if (strncmp(path, "/list", 5) == 0) {
-            char *page = build_list_html();
-            if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
-            else { send_text(client, "200 OK", "text/html; charset=utf-8", page); free(page); }
-            close(client); return;
+        fprintf(f, "</table></body></html>");
+        fclose(f);
+    }
+    /* the session is closed: tell the semester's streams */
+    Buf ev = { .arena = arena };
+    JsonWriter jw; json_init(&jw, &ev);
+    json_obj_begin(&jw);
+    json_key(&jw, "semester"); json_int(&jw, semester);
+    json_key(&jw, "date"); json_str(&jw, datebuf);
+    json_key(&jw, "students"); json_int(&jw, nrows);
+    json_key(&jw, "report"); json_str(&jw, fname);
+    json_key(&jw, "subjects"); json_arr_begin(&jw);
+    for (int sj=0; sj<subj_count; ++sj)
+        if (ev.len + strlen(subjects[sj]) + 8 < FEED_DATA_MAX) json_str(&jw, subjects[sj]);
+    json_arr_end(&jw);
+    json_obj_end(&jw);
+    char *evdata = buf_finish(&ev);
+
+    unsigned int first = mut_begin(), ticket = 0;
+    int r = 0;
+    do {
+        cmd.nstudents = 0;
+        cmd.present = 0;
+        for (; r < nrows && cmd.nstudents < MUT_STUDENTS; ++r) {
+            int i = rows[r];
+            if ((present[i >> 5] >> (i & 31)) & 1) cmd.present |= 1ull << cmd.nstudents;
+            cmd.u.students[cmd.nstudents++] = db->students[i].id;
         }
-
-        /* dashboard query: id and pass */
-        if (strncmp(path, "/dashboard", 10) == 0) {
-            /* parse query string after ? */
-            char *q = strchr(fullpath, '?');
-            int id = -1; char pass[128] = {0};
-            if (q) {
-                char *qs = strdup(q+1);
-                char *v = form_value(qs, "id");
-                char *p = form_value(qs, "pass");
-                if (v) { id = atoi(v); free(v); }
-                if (p) { strncpy(pass, p, sizeof(pass)-1); free(p); }
-                free(qs);
-            }
-            if (id <= 0 || pass[0]==0) {
-                send_text(client, "400 Bad Request", "text/plain", "Missing id or pass (use the sign-in form).");
-                close(client); return;
-            }
-            int idx = api_find_index_by_id(id);
-            if (idx == -1) { send_text(client, "404 Not Found", "text/plain", "Student not found"); close(client); return; }
-            if (strcmp(pass, students[idx].password) != 0) { send_text(client, "401 Unauthorized", "text/plain", "Wrong password"); close(client); return; }
-            char *page = build_student_dashboard(idx);
-            if (!page) send_text(client, "500 Internal Server Error", "text/plain", "Server error");
-            else { send_text(client, "200 OK", "text/html; charset=utf-8", page); free(page); }
-            close(client); return;
+        /* the last command carries the event, so it goes out with the changes */
+        if (r == nrows && evdata && ev.len < FEED_DATA_MAX) {
+            snprintf(cmd.event.type, sizeof(cmd.event.type), "attendance");
+            cmd.event.semester = semester;
+            snprintf(cmd.event.data, sizeof(cmd.event.data), "%s", evdata);
         }
+        ticket = mut_push(&cmd);
+    } while (r < nrows);
+    char *ctx = arena_alloc(arena, strlen(fname) + 1);
+    if (!ctx) { send_text(client, "500 Internal Server Error", "text/plain", "Out of memory"); return; }
+    memcpy(ctx, fname, strlen(fname) + 1);
+    mut_reply_later(client, first, ticket, attendance_done, ctx);
+}
 
-        /* Attendance: Step 1 - choose semester */
-        if (strncmp(path, "/attendance", 10) == 0) {
-            /* if query contains semester -> redirect to subject selection */
-            char *q = strchr(fullpath, '?');
-            if (!q) {
-                char *page = build_attendance_sem_select_page();
-                send_text(client, "200 OK", "text/html; charset=utf-8", page);
-                free(page); close(client); return;
-            } else {
-                /* forward to attendance subject selection handler path /attendance-subjects */
-                /* To keep REST simple, we provide a separate route /attendance-subjects */
-                send_text(client, "302 Found", "text/plain", "Redirecting"); close(client); return;
-            }
-        }
+/* /api/v1 and everything below it (any method; the API itself answers 405 for writes) */
+static void route_api(const RouteCtx *rc) {
+    handle_api(rc->client, rc->arena, rc->rq, rc->method, rc->path, rc->form);
+}
 
-        if (strncmp(path, "/attendance-subjects", 19) == 0) {
-            /* parse query ?semester= */
-            char *q = strchr(fullpath, '?');
-            int semester = 0;
-            if (q) {
-                char *qs = strdup(q+1);
-                char *sem = form_value(qs, "semester");
-                if (sem) { semester = atoi(sem); free(sem); }
-                free(qs);
-            }
-            if (semester < 1 || semester > 8) {
-                char *page = build_attendance_sem_select_page();
-                send_text(client, "200 OK", "text/html; charset=utf-8", page);
-                free(page); close(client); return;
-            }
-            char *page = build_attendance_subjects_page(semester, NULL);
-            send_text(client, "200 OK", "text/html; charset=utf-8", page);
-            free(page); close(client); return;
-        }
+/* /jobs: queue background work and follow it (admin, Basic auth like the API).
+   POST /jobs kind=export|results|recompute [semester=N] [priority=high|normal|low]
+   answers 202 with the job; GET /jobs/<id> reports state, progress and,
+   once done, the artifact URL; GET /jobs/<id>/artifact downloads it;
+   POST /jobs/<id>/cancel stops it. */
+static void job_write(JsonWriter *w, const Job *j) {
+    json_obj_begin(w);
+    json_key(w, "id"); json_int(w, (long)j->id);
+    json_key(w, "kind"); json_str(w, JOB_KINDS[j->kind].name);
+    if (JOB_KINDS[j->kind].needs_semester) { json_key(w, "semester"); json_int(w, j->semester); }
+    json_key(w, "priority"); json_str(w, JOB_PRIORITY_NAMES[j->priority]);
+    json_key(w, "state"); json_str(w, JOB_STATES[j->state]);
+    json_key(w, "progress"); json_obj_begin(w);
+    json_key(w, "done"); json_int(w, atomic_load(&j->done));
+    json_key(w, "total"); json_int(w, atomic_load(&j->total));
+    json_obj_end(w);
+    json_key(w, "artifact");
+    if (j->state == JOB_DONE) {
+        char url[48];
+        snprintf(url, sizeof(url), "/jobs/%u/artifact", j->id);
+        json_str(w, url);
+    } else json_null(w);
+    if (j->state == JOB_FAILED) { json_key(w, "error"); json_str(w, j->error); }
+    json_key(w, "created"); json_int(w, (long)j->created);
+    json_key(w, "started"); if (j->started) json_int(w, (long)j->started); else json_null(w);
+    json_key(w, "finished"); if (j->finished) json_int(w, (long)j->finished); else json_null(w);
+    json_obj_end(w);
+}
 
-        if (strncmp(path, "/attendance-mark", 15) == 0) {
-            /* parse query: semester and subject repeated */
-            char *q = strchr(fullpath, '?');
-            int semester = 0;
-            char *subjects[64]; int subj_count=0;
-            if (q) {
-                char *qs = strdup(q+1);
-                char *sem = form_value(qs, "semester");
-                if (sem) { semester = atoi(sem); free(sem); }
-                /* collect all 'subject' occurrences by scanning qs */
-                const char *p = qs;
-                while ((p = strstr(p, "subject=")) != NULL) {
-                    p += strlen("subject=");
-                    /* read until & or end and unescape */
-                    const char *amp = strchr(p, '&');
-                    size_t len = amp ? (size_t)(amp - p) : strlen(p);
-                    char *val = malloc(len+1);
-                    memcpy(val, p, len); val[len]=0; urldecode_inplace(val);
-                    if (subj_count < 64) subjects[subj_count++] = val;
-                    if (!amp) break;
-                    p = amp + 1;
-                }
-                free(qs);
-            }
-            if (semester < 1 || subj_count==0) {
-                /* redirect to semester select */
-                char *page = build_attendance_sem_select_page();
-                send_text(client, "200 OK", "text/html; charset=utf-8", page);
-                free(page); close(client); return;
-            }
-            char *page = build_attendance_mark_page(semester, subjects, subj_count);
-            for (int i=0;i<subj_count;++i) free(subjects[i]);
-            send_text(client, "200 OK", "text/html; charset=utf-8", page);
-            free(page); close(client); return;
-        }
+/* copy of the job with this id under the job lock; 0 if it is gone */
+static int job_snapshot(unsigned int id, Job *out) {
+    int found = 0;
+    job_lock();
+    for (int i = 0; i < JOB_MAX && !found; ++i) {
+        if (store->jobs[i].id != id || !id) continue;
+        memcpy(out, &store->jobs[i], sizeof(*out));
+        found = 1;
+    }
+    job_unlock();
+    return found;
+}
 
-        /* marks entry: Step 1 page to input student id */
-        if (strncmp(path, "/enter-marks", 11) == 0 && strstr(fullpath, "student") == NULL) {
-            /* show ID entry page */
-            char *page = build_marks_enter_id_page(NULL);
-            send_text(client, "200 OK", "text/html; charset=utf-8", page);
-            free(page); close(client); return;
-        }
+static void job_send(int client, Arena *a, const char *status, const Job *j, const char *extra) {
+    Buf b = { .arena = a };
+    JsonWriter w; json_init(&w, &b);
+    job_write(&w, j);
+    if (b.oom) { api_send_json(client, status, &b); return; }
+    send_response_headers(client, status, "application/json; charset=utf-8", extra, b.data, b.len);
+}
 
-        /* marks entry: show student marks table when id provided as query (route /enter-marks-student?id=) */
-        if (strncmp(path, "/enter-marks-student", 20) == 0) {
-            char *q = strchr(fullpath, '?');
-            int sid = 0;
-            if (q) {
-                char *qs = strdup(q+1);
-                char *v = form_value(qs, "id");
-                if (v) { sid = atoi(v); free(v); }
-                free(qs);
-            }
-            if (sid <= 0) {
-                char *page = build_marks_enter_id_page("Please provide a valid student ID.");
-                send_text(client, "200 OK", "text/html; charset=utf-8", page);
-                free(page); close(client); return;
-            }
-            char *page = build_marks_table_page_for_student(sid, NULL);
-            if (!page) send_text(client, "404 Not Found", "text/plain", "Student not found");
-            else { send_text(client, "200 OK", "text/html; charset=utf-8", page); free(page); }
-            close(client); return;
-        }
+/* POST /jobs */
+static void route_job_submit(const RouteCtx *rc) {
+    if (!api_request_authorized(rc->rq)) { api_send_unauthorized(rc->client); return; }
+    const char *kind_s = form_get(rc->form, "kind");
+    int kind = kind_s ? job_kind_find(kind_s) : -1;
+    if (kind < 0) { api_send_error(rc->client, rc->arena, "400 Bad Request", "kind must be export, results or recompute"); return; }
+    int semester = 0;
+    if (JOB_KINDS[kind].needs_semester) {
+        const char *v = form_get(rc->form, "semester");
+        semester = v ? atoi(v) : 0;
+        if (semester < 1 || semester > 8) { api_send_error(rc->client, rc->arena, "400 Bad Request", "semester must be 1-8"); return; }
+    }
+    int priority = JOB_KINDS[kind].priority;
+    const char *pr = form_get(rc->form, "priority");
+    if (pr) {
+        for (priority = 0; priority < JOB_PRIORITIES && strcmp(JOB_PRIORITY_NAMES[priority], pr) != 0; ++priority) {}
+        if (priority == JOB_PRIORITIES) { api_send_error(rc->client, rc->arena, "400 Bad Request", "priority must be high, normal or low"); return; }
+    }
+    unsigned int id = job_submit(kind, priority, semester);
+    Job j;
+    if (!id || !job_snapshot(id, &j)) { api_send_error(rc->client, rc->arena, "503 Service Unavailable", "job queue full"); return; }
+    char loc[48];
+    snprintf(loc, sizeof(loc), "Location: /jobs/%u\r\n", id);
+    job_send(rc->client, rc->arena, "202 Accepted", &j, loc);
+}
 
-    } /* end GET */
-
-    /* POST handlers */
-    if (strcmp(method, "POST") == 0) {
-        char *body = strstr(req, "\r\n\r\n");
-        if (!body) { send_text(client, "400 Bad Request", "text/plain", "No body"); close(client); return; }
-        body += 4;
-
-        /* Admin login */
-        if (strncmp(path, "/admin-login", 12) == 0) {
-            char *user = form_value(body, "username");
-            char *pass = form_value(body, "password");
-            if (!user || !pass) {
-                send_text(client, "400 Bad Request", "text/plain", "Missing username or password");
-                if (user) free(user); if (pass) free(pass);
-                close(client); return;
-            }
-            int ok = api_admin_auth(user, pass); /* uses student_system.c auth */
-            free(user); free(pass);
-            if (!ok) { send_text(client, "401 Unauthorized", "text/plain", "Invalid admin credentials"); close(client); return; }
-            /* admin dashboard with new flows */
-            const char *adm =
-              "<!doctype html><html><head><meta charset='utf-8'><title>Admin Dashboard</title>"
-              "<style>body{font-family:Arial;margin:18px} .card{max-width:900px;padding:18px;border-radius:10px;background:#fff;border:1px solid #eee} input,button,textarea,select{padding:8px;margin:6px 0;width:100%} button{background:#0b69ff;color:#fff;border:none;border-radius:6px}</style></head><body>"
-              "<div class='card'><h2>Admin Dashboard</h2>"
-              "<p>Manage marks and attendance.</p>"
-              "<h3>View all students</h3><p><a href='/list'>Open students list</a></p>"
-              "<h3>Enter marks for a student</h3>"
-              "<p><a href='/enter-marks'>Enter marks (open by student ID)</a></p>"
-              "<h3>Mark attendance</h3>"
-              "<p><a href='/attendance'>Start attendance flow (select semester → subject → mark)</a></p>"
-              "<p><a href='/'>Back</a></p></div></body></html>";
-            send_text(client, "200 OK", "text/html; charset=utf-8", adm);
-            close(client); return;
+/* GET /jobs/<id> and GET /jobs/<id>/artifact */
+static void route_job_status(const RouteCtx *rc) {
+    if (!api_request_authorized(rc->rq)) { api_send_unauthorized(rc->client); return; }
+    char *end = NULL;
+    unsigned int id = (unsigned int)strtoul(rc->param, &end, 10);
+    int artifact = end && strcmp(end, "/artifact") == 0;
+    if (!end || (*end && !artifact)) { api_send_error(rc->client, rc->arena, "404 Not Found", "unknown resource"); return; }
+    Job j;
+    if (!job_snapshot(id, &j)) {
+        api_send_error(rc->client, rc->arena, "404 Not Found", "no such job");
+        return;
+    }
+    if (!artifact) { job_send(rc->client, rc->arena, "200 OK", &j, ""); return; }
+    if (j.state != JOB_DONE || !j.artifact[0]) { api_send_error(rc->client, rc->arena, "409 Conflict", "job has no artifact"); return; }
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), JOB_DIR "/%s", j.artifact);
+    serve_file(rc->client, rc->arena, path);
+}
+
+/* POST /jobs/<id>/cancel: a queued job is dropped, a running one asked to stop */
+static void route_job_cancel(const RouteCtx *rc) {
+    if (!api_request_authorized(rc->rq)) { api_send_unauthorized(rc->client); return; }
+    char *end = NULL;
+    unsigned int id = (unsigned int)strtoul(rc->param, &end, 10);
+    if (!end || strcmp(end, "/cancel") != 0) { api_send_error(rc->client, rc->arena, "404 Not Found", "unknown resource"); return; }
+    int found = 0, live = 0;
+    job_lock();
+    for (int i = 0; i < JOB_MAX && id; ++i) {
+        Job *j = &store->jobs[i];
+        if (j->id != id) continue;
+        found = 1;
+        live = j->state == JOB_QUEUED || j->state == JOB_RUNNING;
+        if (j->state == JOB_QUEUED) { j->state = JOB_CANCELLED; j->finished = (long long)time(NULL); }
+        else if (j->state == JOB_RUNNING) atomic_store(&j->cancel, 1);
+    }
+    job_unlock();
+    Job j;
+    if (!found || !job_snapshot(id, &j)) { api_send_error(rc->client, rc->arena, "404 Not Found", "no such job"); return; }
+    if (!live) { api_send_error(rc->client, rc->arena, "409 Conflict", "job already finished"); return; }
+    job_send(rc->client, rc->arena, "202 Accepted", &j, "");
+}
+
+static const Route ROUTES[] = {
+    { M_ANY,  "/api/v1",              route_api,                  COST_NORMAL },
+    { M_ANY,  "/api/v1/*",            route_api,                  COST_NORMAL },
+    { M_GET,  "/",                    route_landing,              COST_LIGHT },
+    { M_GET,  "/reports/*",           route_report,               COST_HEAVY },
+    { M_GET,  "/static/*",            route_static,               COST_LIGHT },
+    { M_GET,  "/list",                route_list,                 COST_HEAVY },
+    { M_GET,  "/dashboard",           route_dashboard,            COST_NORMAL },
+    { M_GET,  "/events",              route_events,               COST_LIGHT },
+    { M_POST, "/login",               route_login,                COST_NORMAL },
+    { M_POST, "/logout",              route_logout,               COST_LIGHT },
+    { M_GET,  "/attendance",          route_attendance_start,     COST_LIGHT },
+    { M_GET,  "/attendance-subjects", route_attendance_subjects,  COST_LIGHT },
+    { M_ANY,  "/attendance-mark",     route_attendance_mark_page, COST_NORMAL },
+    { M_GET,  "/enter-marks",         route_marks_id_page,        COST_LIGHT },
+    { M_GET,  "/enter-marks-student", route_marks_student_page,   COST_NORMAL },
+    { M_POST, "/admin-login",         route_admin_login,          COST_LIGHT },
+    { M_POST, "/student-signup",      route_student_signup,       COST_NORMAL },
+    { M_POST, "/enter-marks",         route_marks_submit,         COST_NORMAL },
+    { M_POST, "/attendance",          route_attendance_submit,    COST_HEAVY },
+    { M_POST, "/jobs",                route_job_submit,           COST_LIGHT },
+    { M_GET,  "/jobs/*",              route_job_status,           COST_LIGHT },
+    { M_POST, "/jobs/*",              route_job_cancel,           COST_LIGHT },
+};
+
+static void send_method_not_allowed(int client, const Route *const *slots) {
+    char allow[64];
+    snprintf(allow, sizeof(allow), "Allow: %s%s%s\r\n", slots[M_GET] ? "GET" : "",
+             slots[M_GET] && slots[M_POST] ? ", " : "", slots[M_POST] ? "POST" : "");
+    send_response_headers(client, "405 Method Not Allowed", "text/plain", allow, "Method not allowed", 18);
+}
+
+static void handle_request(int client, Arena *arena, HttpRequest *rq, const FormTable *form) {
+    char method[17], path[1024];
+    slice_copy(rq->method, method, sizeof(method));
+    slice_copy(rq->path, path, sizeof(path));
+    int m = strcmp(method, "GET") == 0 ? M_GET : strcmp(method, "POST") == 0 ? M_POST : M_OTHER;
+
+    RouteCtx rc = { client, arena, rq, form, method, path, "" };
+    const Route *const *slots = route_match(path, &rc.param);
+
+    if (!slots) send_text(client, "404 Not Found", "text/plain", "Not found");
+    else if (!slots[m]) send_method_not_allowed(client, slots);
+    else if (!admit(slots[m]->cost)) send_overloaded(client);
+    else {
+        /* writes read their snapshot too and queue their changes */
+        db = store_enter(pin_self);
+        slots[m]->fn(&rc);
+        store_exit(pin_self);
+        db = NULL;
+    }
+}
+
+/* ---------- Event loop ---------- */
+static void conn_close(Conn *c) {
+    timer_clear(c);
+    if (c->state == CONN_STREAM) sse_unlink(c);
+    if (c->state == CONN_WAIT) wait_unlink(c);
+    close(c->fd);               /* also drops it from the epoll set */
+    conn_release(c);
+}
+
+/* write as much of the queued response as the socket takes; the connection
+   is closed once it is all out */
+static void conn_flush(Conn *c) {
+    if (c->out.oom) { conn_close(c); return; }
+    while (c->out_sent < c->out.len) {
+        ssize_t w = send(c->fd, c->out.data + c->out_sent, c->out.len - c->out_sent, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = c };
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+            return;
         }
+        if (w <= 0) break;
+        c->out_sent += (size_t)w;
+    }
+    conn_close(c);
+}
 
-        /* Student sign-up */
-        if (strncmp(path, "/student-signup", 16) == 0) {
-            char *name = form_value(body, "name");
-            char *age = form_value(body, "age");
-            char *sap = form_value(body, "sap_id");
-            char *password = form_value(body, "password");
-            char *email = form_value(body, "email");
-            char *phone = form_value(body, "phone");
-            char *semester = form_value(body, "semester");
-            if (!name || !age || !sap || !password || !email || !phone || !semester) {
-                send_text(client, "400 Bad Request", "text/plain", "Missing fields");
-                goto signup_cleanup;
-            }
-            int sapid = atoi(sap);
-            int sem = atoi(semester);
-            if (sapid <= 0 || sem < 1 || sem > 8) {
-                char resp[256];
-                snprintf(resp, sizeof(resp),
-                    "<!doctype html><html><body><p>Invalid SAP ID or semester provided.</p><p><a href='/'>Back</a></p></body></html>");
-                send_text(client, "400 Bad Request", "text/html; charset=utf-8", resp);
-                goto signup_cleanup;
-            }
-            Student s; memset(&s, 0, sizeof(s));
-            s.exists = 1; s.cgpa = 0.0; s.total_credits_completed = 0;
-            s.id = sapid;
-            strncpy(s.name, name, sizeof(s.name)-1); s.name[sizeof(s.name)-1]=0;
-            s.age = atoi(age);
-            strncpy(s.email, email, sizeof(s.email)-1); s.email[sizeof(s.email)-1]=0;
-            strncpy(s.phone, phone, sizeof(s.phone)-1); s.phone[sizeof(s.phone)-1]=0;
-            strncpy(s.dept, "B.Tech CSE", sizeof(s.dept)-1); s.dept[sizeof(s.dept)-1]=0;
-            s.year = 1;
-            s.current_semester = sem;
-            s.num_subjects = 0;
-            strncpy(s.password, password, sizeof(s.password)-1); s.password[sizeof(s.password)-1]=0;
-
-            /* Default semester subjects arrays are same as student_system.c; we'll add simple lists here */
-            const char *sem1[] = {
-                "Programming in C","Linux Lab","Problem Solving","Advanced Engineering Mathematics - I","Physics for Computer Engineers","Managing Self","Environmental Sustainability and Climate Change", NULL
-            };
-            const int sem1_c[] = {5,2,2,4,5,2,2};
-            const char *sem2[] = {
-                "Data Structures and Algorithms","Digital Electronics","Python Programming","Advanced Engineering Mathematics - II","Environmental Sustainability and Climate Change","Time and Priority Management","Elements of AI/ML", NULL
-            };
-            const int sem2_c[] = {5,3,5,4,2,2,3};
-            const char *sem3[] = {
-                "Leading Conversations","Discrete Mathematical Structures","Operating Systems","Elements of AI/ML","Database Management Systems","Design and Analysis of Algorithms", NULL
-            };
-            const int sem3_c[] = {2,3,3,3,5,4};
-            const char *sem4[] = {
-                "Software Engineering","EDGE - Soft Skills","Linear Algebra","Indian Constitution","Writing with Impact","Object Oriented Programming","Data Communication and Networks","Applied Machine Learning", NULL
-            };
-            const int sem4_c[] = {3,0,3,0,2,4,4,5};
-            const char *sem5[] = {
-                "Cryptography and Network Security","Formal Languages and Automata Theory","Object Oriented Analysis and Design","Exploratory-3","Start your Startup","Research Methodology in CS","Probability, Entropy, and MC Simulation","PE-2","PE-2 Lab", NULL
-            };
-            const int sem5_c[] = {3,3,3,3,2,3,3,4,1};
-            const char *sem6[] = {
-                "Exploratory-4","Leadership and Teamwork","Compiler Design","Statistics and Data Analysis","PE-3","PE-3 Lab","Minor Project", NULL
-            };
-            const int sem6_c[] = {3,2,3,3,4,1,5};
-            const char *sem7[] = {
-                "Exploratory-5","PE-4","PE-4 Lab","PE-5","PE-5 Lab","Capstone Project - Phase-1","Summer Internship", NULL
-            };
-            const int sem7_c[] = {3,4,1,3,1,5,1};
-            const char *sem8[] = {
-                "IT Ethical Practices","Capstone Project - Phase-2", NULL
-            };
-            const int sem8_c[] = {3,5};
-
-            for (int cur=1; cur<=sem; ++cur) {
-                if (cur==1) {
-                    for (int i=0; sem1[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem1[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem1_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==2) {
-                    for (int i=0; sem2[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem2[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem2_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==3) {
-                    for (int i=0; sem3[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem3[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem3_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==4) {
-                    for (int i=0; sem4[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem4[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem4_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==5) {
-                    for (int i=0; sem5[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem5[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem5_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==6) {
-                    for (int i=0; sem6[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem6[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem6_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==7) {
-                    for (int i=0; sem7[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem7[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem7_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                } else if (cur==8) {
-                    for (int i=0; sem8[i]!=NULL; ++i) {
-                        if (s.num_subjects < MAX_SUBJECTS) {
-                            strncpy(s.subjects[s.num_subjects].name, sem8[i], MAX_SUB_NAME-1); s.subjects[s.num_subjects].name[MAX_SUB_NAME-1]=0;
-                            s.subjects[s.num_subjects].credits = sem8_c[i];
-                            s.subjects[s.num_subjects].marks = 0;
-                            s.subjects[s.num_subjects].classes_held = 0;
-                            s.subjects[s.num_subjects].classes_attended = 0;
-                            s.num_subjects++;
-                        }
-                    }
-                }
-            }
+/* the handler left its response to mut_reply_later: no deadline, and no
+   events but a hangup, until the applier has done its tickets */
+static void conn_park(Conn *c) {
+    timer_clear(c);
+    struct epoll_event ev = { .events = 0, .data.ptr = c };
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    wait_link(c);
+}
 
-            /* Save via API */
-            int addres = api_add_student(&s);
-            if (addres == -2) {
-                char resp[256];
-                snprintf(resp, sizeof(resp),
-                    "<!doctype html><html><body><p>SAP ID %d already registered. Try signing in.</p><p><a href='/'>Back</a></p></body></html>",
-                    s.id);
-                send_text(client, "409 Conflict", "text/html; charset=utf-8", resp);
-            } else if (addres <= 0) {
-                send_text(client, "500 Internal Server Error", "text/plain", "Unable to register");
-            } else {
-                char resp[512];
-                snprintf(resp, sizeof(resp),
-                    "<!doctype html><html><body><p>Registration successful!</p>"
-                    "<p>Your Student ID (SAP ID): <strong>%d</strong></p>"
-                    "<p>Default subjects for semester %d and earlier have been added automatically.</p>"
-                    "<p><a href='/'>Back to Home</a></p></body></html>", addres, sem);
-                send_text(client, "200 OK", "text/html; charset=utf-8", resp);
-            }
+/* switch the connection to writing whatever has been queued */
+static void conn_respond(Conn *c) {
+    if (c->wait_done) { conn_park(c); return; }
+    if (c->stream) { sse_start(c); return; }
+    c->state = CONN_WRITE;
+    timer_set(c, now_ms() + WRITE_TIMEOUT_MS);
+    conn_flush(c);
+}
+
+static void conn_fail(Conn *c, int status) {
+    c->out.len = 0;
+    send_text(c->fd, http_status_text(status), "text/plain", status == 408 ? "Request timeout" : "Bad request");
+    conn_respond(c);
+}
+
+/* run the request now that it has fully arrived */
+static void conn_serve(Conn *c) {
+    HttpRequest *rq = &c->req;
+    /* decode the form once: the body for POST, otherwise the query string */
+    FormTable form;
+    if (slice_eq(rq->method, "POST")) form_parse(&form, &c->arena, rq->body, rq->body_len);
+    else form_parse(&form, &c->arena, rq->query.p ? rq->query.p : "", rq->query.n);
+    handle_request(c->fd, &c->arena, rq, &form);
+    conn_respond(c);
+}
+
+static void conn_readable(Conn *c) {
+    int rr = conn_read(c);
+    if (rr == 0) return;
+    if (rr == 1) conn_serve(c);
+    else if (rr < 0) conn_close(c);
+    else conn_fail(c, rr);
+}
+
+/* the applier signalled: finish the parked requests whose tickets are done */
+static void conn_wake(void) {
+    unsigned long long n;
+    if (read(mut_efd[pin_self], &n, sizeof(n)) < 0 && errno != EAGAIN) perror("eventfd");
+    for (Conn *c = conn_waiting, *next; c; c = next) {
+        next = c->wnext;
+        if (!mut_done(c->wait_last)) continue;
+        wait_unlink(c);
+        MutDoneFn done = c->wait_done;
+        c->wait_done = NULL;
+        done(c->fd, &c->arena, c->wait_ctx, mut_sum(c->wait_first, c->wait_last));
+        conn_respond(c);
+    }
+}
+
+/* a deadline passed: a client part way through a request gets a 408; an
+   idle one, or one too slow to take its response, is simply dropped; an
+   event stream is due its ping */
+static void conn_expire(Conn *c) {
+    if (c->state == CONN_STREAM) sse_ping(c);
+    else if (c->state == CONN_WRITE || (c->state == CONN_HEAD && c->head_len == 0)) conn_close(c);
+    else conn_fail(c, 408);
+}
 
-        signup_cleanup:
-            if (name) free(name);
-            if (age) free(age);
-            if (sap) free(sap);
-            if (password) free(password);
-            if (email) free(email);
-            if (phone) free(phone);
-            if (semester) free(semester);
-            close(client); return;
+/* expire everything in the ticks that have fully elapsed; a slot is only
+   visited once its whole tick is past, so each deadline fires at most one
+   tick late */
+static void wheel_advance(long long now) {
+    long long tick = now / WHEEL_TICK_MS;
+    if (tick - wheel_tick > WHEEL_SLOTS) wheel_tick = tick - WHEEL_SLOTS;
+    for (; wheel_tick < tick; ++wheel_tick) {
+        Conn *c = wheel[wheel_tick & (WHEEL_SLOTS - 1)];
+        while (c) {
+            Conn *next = c->tnext;
+            if (c->deadline <= now) conn_expire(c);
+            c = next;
         }
+    }
+}
 
-        /* Enter marks (admin) - POST endpoint /enter-marks */
-        if (strncmp(path, "/enter-marks", 12) == 0) {
-            /* body contains fields id and many m_<subject>=<marks> entries */
-            char *id_s = form_value(body, "id");
-            if (!id_s) {
-                send_text(client, "400 Bad Request", "text/plain", "Missing id");
-                close(client); return;
-            }
-            int sid = atoi(id_s); free(id_s);
-            int idx = api_find_index_by_id(sid);
-            if (idx == -1) {
-                send_text(client, "404 Not Found", "text/plain", "Student not found");
-                close(client); return;
-            }
-            Student *s = &students[idx];
-            /* naive parser: iterate over all "m_" occurrences and set marks */
-            const char *p = body;
-            int updated = 0;
-            while ((p = strstr(p, "m_")) != NULL) {
-                /* p points at m_<subject>=value ... */
-                p += 2;
-                /* read subject name up to '=' */
-                const char *eq = strchr(p, '=');
-                if (!eq) break;
-                size_t sname_len = (size_t)(eq - p);
-                char *sname_enc = malloc(sname_len+1);
-                memcpy(sname_enc, p, sname_len); sname_enc[sname_len]=0;
-                urldecode_inplace(sname_enc);
-                /* read value */
-                const char *val_start = eq + 1;
-                /* value up to & or end */
-                const char *amp = strchr(val_start, '&');
-                size_t vlen = amp ? (size_t)(amp - val_start) : strlen(val_start);
-                char *venc = malloc(vlen+1);
-                memcpy(venc, val_start, vlen); venc[vlen]=0;
-                urldecode_inplace(venc);
-                int mk = atoi(venc);
-                /* apply: find subject by exact name and set marks */
-                for (int i=0;i<s->num_subjects;++i) {
-                    if (strcmp(s->subjects[i].name, sname_enc)==0) {
-                        if (mk < 0) mk = 0; if (mk > 100) mk = 100;
-                        s->subjects[i].marks = mk;
-                        updated++;
-                        break;
-                    }
-                }
-                free(sname_enc); free(venc);
-                if (!amp) break;
-                p = amp + 1;
-            }
-            /* recalc CGPA via API */
-            api_calculate_update_cgpa(idx);
-            save_data();
-            char resp[256];
-            snprintf(resp, sizeof(resp), "<p>Marks updated for ID %d (%d subjects updated). <a href='/admin'>Back</a></p>", sid, updated);
-            send_text(client, "200 OK", "text/html; charset=utf-8", resp);
-            close(client); return;
+static void accept_ready(int server_fd) {
+    for (;;) {
+        int client = accept4(server_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept");
+            return;
+        }
+        if (client >= CONN_FD_MAX || conn_count >= max_conns) {
+            /* saturated: answer straight from the listener and move on */
+            send(client, OVERLOADED, sizeof(OVERLOADED) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+            close(client);
+            continue;
+        }
+        Conn *c = conn_acquire(client);
+        if (!c) { close(client); continue; }
+        timer_set(c, now_ms() + HEAD_TIMEOUT_MS);
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &ev) < 0) conn_close(c);
+    }
+}
+
+static void serve_forever(int server_fd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &ev);
+    struct epoll_event wev = { .events = EPOLLIN, .data.ptr = EV_WAKE };
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, mut_efd[pin_self], &wev);
+    wheel_tick = now_ms() / WHEEL_TICK_MS;
+    struct epoll_event events[64];
+    for (;;) {
+        int n = epoll_wait(epoll_fd, events, 64, WHEEL_TICK_MS);
+        if (n < 0 && errno != EINTR) { perror("epoll_wait"); return; }
+        for (int i = 0; i < n; ++i) {
+            Conn *c = events[i].data.ptr;
+            if (!c) accept_ready(server_fd);
+            else if ((void *)c == EV_WAKE) conn_wake();
+            else if (c->state == CONN_WAIT) conn_close(c);     /* hung up while parked */
+            else if (c->state == CONN_WRITE) conn_flush(c);
+            else if (c->state == CONN_STREAM) sse_ready(c, events[i].events);
+            else conn_readable(c);
         }
+        feed_pump();
+        wheel_advance(now_ms());
+    }
+}
 
-        /* Attendance POST (admin) - POST to /attendance (from build_attendance_mark_page) */
-        if (strncmp(path, "/attendance", 10) == 0) {
-            /* parse semester and subject hidden fields + date + present_N fields */
-            char *sem_s = form_value(body, "semester");
-            if (!sem_s) { send_text(client, "400 Bad Request", "text/plain", "Missing semester"); close(client); return; }
-            int semester = atoi(sem_s); free(sem_s);
-            /* collect subject occurrences from hidden fields 'subject' - there may be multiple */
-            char *subjects[64]; int subj_count=0;
-            {
-                const char *p = body;
-                while ((p = strstr(p, "subject=")) != NULL) {
-                    p += strlen("subject=");
-                    const char *amp = strchr(p, '&');
-                    size_t len = amp ? (size_t)(amp - p) : strlen(p);
-                    char *val = malloc(len+1);
-                    memcpy(val, p, len); val[len]=0; urldecode_inplace(val);
-                    if (subj_count < 64) subjects[subj_count++] = val;
-                    if (!amp) break;
-                    p = amp + 1;
-                }
+/* --bench-http [N]: time the request parser on a header-heavy request, fed
+   whole and in 64-byte pieces the way slow clients deliver it */
+static int bench_http_parser(long iters) {
+    Buf req = {0};
+    buf_puts(&req, "POST /enter-marks?id=500123&semester=3 HTTP/1.1\r\nHost: results.example.edu:8080\r\n");
+    buf_puts(&req, "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n");
+    buf_puts(&req, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n");
+    buf_puts(&req, "Accept-Language: en-GB,en;q=0.9,hi;q=0.8\r\nAccept-Encoding: gzip, deflate, br\r\n");
+    buf_puts(&req, "Content-Type: application/x-www-form-urlencoded\r\nContent-Length: 0\r\n");
+    for (int i = 0; i < 24; ++i)
+        buf_printf(&req, "X-Forwarded-Trace-%02d: hop=%d; proxy=campus-gw-%02d.example.edu; ts=1700000000%03d\r\n", i, i, i, i);
+    buf_puts(&req, "Cookie: sessionid=0123456789abcdef0123456789abcdef; theme=light; csrftoken=fedcba9876543210fedcba9876543210\r\n\r\n");
+    if (req.oom) return 1;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        size_t step = mode == 0 ? req.len : 64;
+        struct timespec t0, t1;
+        long ok = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (long it = 0; it < iters; ++it) {
+            HttpParser hp; http_parser_init(&hp);
+            int rc = HP_NEED_MORE;
+            for (size_t have = 0; rc == HP_NEED_MORE && have < req.len; ) {
+                have = have + step < req.len ? have + step : req.len;
+                rc = http_parse(&hp, req.data, have);
             }
-            /* collect present_X parameters: present_0, present_1 ... For simplicity, we detect all "present_" occurrences followed by value (student id) */
-            int present_ids[4096]; int present_count = 0;
-            const char *p = body;
-            while ((p = strstr(p, "present_")) != NULL) {
-                /* skip until '=' */
-                const char *eq = strchr(p, '=');
-                if (!eq) break;
-                const char *val_start = eq + 1;
-                const char *amp = strchr(val_start, '&');
-                size_t len = amp ? (size_t)(amp - val_start) : strlen(val_start);
-                char *v = malloc(len+1);
-                memcpy(v, val_start, len); v[len]=0; urldecode_inplace(v);
-                int vid = atoi(v);
-                if (vid>0 && present_count < (int)(sizeof(present_ids)/sizeof(int))) present_ids[present_count++] = vid;
-                free(v);
-                if (!amp) break;
-                p = amp + 1;
-            }
-            /* apply attendance marking: For every student in that semester who has subject(s) selected, increment classes_held for those subjects, and if present, increment classes_attended */
-            int processed = 0;
-            for (int i=0;i<student_count;++i) {
-                if (!students[i].exists) continue;
-                if (students[i].current_semester != semester) continue;
-                for (int sj=0; sj<subj_count; ++sj) {
-                    for (int k=0;k<students[i].num_subjects;++k) {
-                        if (strcmp(students[i].subjects[k].name, subjects[sj])==0) {
-                            students[i].subjects[k].classes_held += 1;
-                            /* check present */
-                            int was_present = 0;
-                            for (int pi=0; pi<present_count; ++pi) if (present_ids[pi] == students[i].id) { was_present = 1; break; }
-                            if (was_present) students[i].subjects[k].classes_attended += 1;
-                            processed++;
-                        }
-                    }
-                }
-            }
-            save_data();
-            /* write a small attendance report file */
-            ensure_reports_dir();
-            time_t t = time(NULL); struct tm tm = *localtime(&t);
-            char datebuf[64];
-            snprintf(datebuf, sizeof(datebuf), "%04d-%02d-%02d", tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday);
-            char fname[256];
-            /* slugify first subject only to create filename */
-            char subslug[128]; slugify(subjects[0] ? subjects[0] : "attendance", subslug, sizeof(subslug));
-            snprintf(fname, sizeof(fname), "attendance_%d_%s_%s.html", semester, datebuf, subslug);
-            char fpath[PATH_MAX]; snprintf(fpath, sizeof(fpath), "reports/%s", fname);
-            FILE *f = fopen(fpath, "w");
-            if (f) {
-                fprintf(f, "<!doctype html><html><head><meta charset='utf-8'><title>Attendance</title></head><body>");
-                fprintf(f, "<h2>Attendance - Semester %d - %s</h2><table border='1' cellpadding='6'><tr><th>ID</th><th>Name</th>", semester, datebuf);
-                for (int sj=0; sj<subj_count; ++sj) fprintf(f, "<th>%s</th>", subjects[sj]);
-                fprintf(f, "</tr>");
-                for (int i=0;i<student_count;++i) {
-                    if (!students[i].exists) continue;
-                    if (students[i].current_semester != semester) continue;
-                    /* see if student has at least one of the subjects */
-                    int has_any = 0; for (int sj=0; sj<subj_count; ++sj) {
-                        for (int k=0;k<students[i].num_subjects;++k) if (strcmp(students[i].subjects[k].name, subjects[sj])==0) { has_any=1; break; }
-                        if (has_any) break;
-                    }
-                    if (!has_any) continue;
-                    fprintf(f, "<tr><td>%d</td><td>%s</td>", students[i].id, students[i].name);
-                    for (int sj=0; sj<subj_count; ++sj) {
-                        int is_present = 0;
-                        for (int pi=0; pi<present_count; ++pi) if (present_ids[pi]==students[i].id) { is_present=1; break; }
-                        fprintf(f, "<td>%s</td>", is_present ? "Yes" : "No");
-                    }
-                    fprintf(f, "</tr>");
-                }
-                fprintf(f, "</table></body></html>");
-                fclose(f);
-            }
-
-            for (int i=0;i<subj_count;++i) free(subjects[i]);
-            char resp[512];
-            snprintf(resp, sizeof(resp), "<p>Attendance marked (processed %d items). Report: <a href='/reports/%s'>%s</a>. <a href='/admin'>Back</a></p>", processed, fname, fname);
-            send_text(client, "200 OK", "text/html; charset=utf-8", resp);
-            close(client); return;
+            if (rc == HP_COMPLETE && hp.nheaders > 30) ok++;
         }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+        printf("http_parse %-8s bytes=%zu iters=%ld ok=%ld  %.1f ns/req  %.1f MB/s\n",
+               mode == 0 ? "whole" : "chunk64", req.len, iters, ok, ns / iters,
+               (double)req.len * iters / (ns / 1e9) / 1e6);
+    }
+    buf_free(&req);
+    return 0;
+}
+
+/* bound, listening, non-blocking socket; reuseport lets every worker
+   process bind the same port and have the kernel spread connections */
+static int open_listener(int port, int reuseport) {
+    int server_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (server_fd < 0) { perror("socket"); return -1; }
+    int opt = 1; setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (reuseport) setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+    struct sockaddr_in addr; memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET; addr.sin_addr.s_addr = INADDR_ANY; addr.sin_port = htons(port);
+    if (bind(server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) { perror("bind"); close(server_fd); return -1; }
+    if (listen(server_fd, listen_backlog) < 0) { perror("listen"); close(server_fd); return -1; }
+    fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL) | O_NONBLOCK);
+    return server_fd;
+}
 
-        /* unknown POST */
-        send_text(client, "404 Not Found", "text/plain", "Not found");
-        close(client); return;
+/* one serving process: its own listener and event loop */
+static int run_server(int port, int reuseport) {
+    int server_fd = open_listener(port, reuseport);
+    if (server_fd < 0) return 1;
+    if (!reuseport) {
+        fprintf(stderr, "Student system web server listening on port %d\n", port);
+        fflush(stderr);
     }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) { perror("epoll_create1"); close(server_fd); return 1; }
+    serve_forever(server_fd);
+    close(server_fd);
+    return 0;
+}
+
+static pid_t spawn_worker(int port, int index) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        prctl(PR_SET_PDEATHSIG, SIGTERM);   /* go down with the master */
+        pin_self = PIN_WORKER0 + index;
+        mut_ticket = atomic_load(&store->replies[pin_self].done);
+        _exit(run_server(port, 1));
+    }
+    if (pid < 0) perror("fork");
+    return pid;
+}
 
-    /* fallback for other methods */
-    send_text(client, "405 Method Not Allowed", "text/plain", "Method not allowed");
-    close(client);
+/* master of WORKERS=N: keeps N workers on the shared port and store,
+   replacing any that die; a worker that fails at startup ends the master */
+static int run_master(int port, int workers) {
+    pid_t *pids = calloc((size_t)workers, sizeof(pid_t));
+    if (!pids) return 1;
+    for (int i = 0; i < workers; ++i) if ((pids[i] = spawn_worker(port, i)) < 0) return 1;
+    for (;;) {
+        int status;
+        pid_t dead = waitpid(-1, &status, 0);
+        if (dead < 0) { if (errno == EINTR) continue; perror("waitpid"); return 1; }
+        if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "worker %d failed to start\n", (int)dead);
+            return 1;
+        }
+        for (int i = 0; i < workers; ++i) {
+            if (pids[i] != dead) continue;
+            fprintf(stderr, "worker %d exited, restarting\n", (int)dead);
+            store_exit(PIN_WORKER0 + i);    /* the snapshot it may have died holding */
+            pids[i] = spawn_worker(port, i);
+        }
+    }
 }
 
-/* main: single-threaded iterative server */
+/* main: single-threaded event-loop server, or WORKERS=N such processes
+   sharing one port and one roster store */
 int main(int argc, char **argv) {
+    if (argc >= 2 && strcmp(argv[1], "--bench-http") == 0)
+        return bench_http_parser(argc >= 3 ? atol(argv[2]) : 200000);
     const char *portenv = getenv("PORT");
     int port = portenv ? atoi(portenv) : 8080;
-    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd < 0) { perror("socket"); return 1; }
-    int opt = 1; setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    struct sockaddr_in addr; memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET; addr.sin_addr.s_addr = INADDR_ANY; addr.sin_port = htons(port);
-    if (bind(server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) { perror("bind"); close(server_fd); return 1; }
-    if (listen(server_fd, 10) < 0) { perror("listen"); close(server_fd); return 1; }
+    const char *env = getenv("LISTEN_BACKLOG");
+    if (env && atoi(env) > 0) listen_backlog = atoi(env);
+    env = getenv("MAX_CONNS");
+    if (env && atoi(env) > 0) max_conns = atoi(env);
+    if (max_conns > CONN_FD_MAX - 64) max_conns = CONN_FD_MAX - 64;
+    env = getenv("PAGE_SIZE");
+    if (env && atoi(env) > 0) page_size = atoi(env) < PAGE_SIZE_MAX ? atoi(env) : PAGE_SIZE_MAX;
+    env = getenv("WORKERS");
+    int workers = env ? atoi(env) : 0;
+    if (workers > STORE_WORKERS_MAX) workers = STORE_WORKERS_MAX;
 
     ensure_reports_dir();
-    fprintf(stderr, "Student system web server listening on port %d\n", port);
-    fflush(stderr);
-
-    while (1) {
-        struct sockaddr_in cli; socklen_t cli_len = sizeof(cli);
-        int client = accept(server_fd, (struct sockaddr*)&cli, &cli_len);
-        if (client < 0) { perror("accept"); continue; }
-        handle_client(client);
+    if (routes_init(ROUTES, sizeof(ROUTES) / sizeof(ROUTES[0])) < 0) { fprintf(stderr, "route table full\n"); exit(1); }
+    static_init();
+    if (store_init(workers) < 0) return 1;
+    data_watch_start();
+    mut_applier_start();
+    jobs_start();
+    if (workers > 0) {
+        fprintf(stderr, "Student system web server listening on port %d (%d workers)\n", port, workers);
+        fflush(stderr);
+        return run_master(port, workers);
     }
-
-    close(server_fd);
-    return 0;
+    return run_server(port, 0);
 }
@@ -0,0 +1,610 @@
+/*
+  student_test.c
+  Student Record & Result Management System - tests for the core library
+  (libstudentcore.a) and the web server's HTTP plumbing (student_http.o)
+
+  Checks the properties the front ends rely on and the bench takes for
+  granted: a roster survives core_save and core_load field for field, the
+  journal can be replayed any number of times with the same result,
+  core_load reports the rows it cannot take and keeps the rest, and
+  core_generate gives the same roster for a seed, a prefix of it for a
+  smaller count, and the same roster again through the CSV path. On the
+  web side: the request parser fed in pieces and at its limits, the form
+  decoder, route matching and the session table. Runs in a scratch
+  directory; prints each failed check and exits 1 if there was one.
+
+  usage: student_test
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#include "student_core.h"
+#include "student_http.h"
+
+static CoreDb a, b, c;
+static int checks, failures, rejected_rows;
+
+#define CHECK(cond, ...) do {                                           \
+        checks++;                                                       \
+        if (!(cond)) {                                                  \
+            failures++;                                                 \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);             \
+            fprintf(stderr, __VA_ARGS__);                               \
+            fputc('\n', stderr);                                        \
+        }                                                               \
+    } while (0)
+
+static void count_rejected(const char *file, int line, const char *row, const char *why) {
+    fprintf(stderr, "rejected %s:%d (%s): %s\n", file, line, why, row);
+    rejected_rows++;
+}
+
+/* ---------- Comparing rosters ---------- */
+static int same_student(const CoreDb *x, int i, const CoreDb *y, int j) {
+    const Student *s = &x->students[i], *t = &y->students[j];
+    if (s->id != t->id || strcmp(s->roll, t->roll) || strcmp(s->name, t->name) || strcmp(s->email, t->email) ||
+        strcmp(s->phone, t->phone) || strcmp(s->dept, t->dept) || strcmp(s->password, t->password) ||
+        s->age != t->age || s->year != t->year || s->current_semester != t->current_semester ||
+        s->exists != t->exists || s->num_subjects != t->num_subjects)
+        return 0;
+    /* the enrollments may be in another order, so look each one up */
+    const Enrollment *e = x->enrollments + s->first;
+    for (int k = 0; k < s->num_subjects; ++k) {
+        const Enrollment *f = core_enrollment((CoreDb *)y, j, e[k].subject);
+        if (!f || f->marks != e[k].marks || f->held != e[k].held || f->attended != e[k].attended) return 0;
+    }
+    return core_gpa(x, i, 0, NULL) == core_gpa(y, j, 0, NULL);
+}
+
+/* the live students of x, in slot order, against those of y */
+static void check_same_roster(const CoreDb *x, const CoreDb *y, const char *what) {
+    CHECK(x->subject_count == y->subject_count, "%s: %d subjects, then %d", what, x->subject_count, y->subject_count);
+    for (int i = 0; i < x->subject_count && i < y->subject_count; ++i)
+        CHECK(strcmp(x->subjects[i].id, y->subjects[i].id) == 0 && x->subjects[i].credits == y->subjects[i].credits &&
+              x->subjects[i].semester == y->subjects[i].semester,
+              "%s: subject row %d differs", what, i);
+    int i = 0, j = 0, differ = 0;
+    for (;; ++i, ++j) {
+        while (i < x->count && !x->students[i].exists) ++i;
+        while (j < y->count && !y->students[j].exists) ++j;
+        if (i == x->count || j == y->count) break;
+        if (!same_student(x, i, y, j) && differ++ < 5)
+            CHECK(0, "%s: student %d differs from %d", what, x->students[i].id, y->students[j].id);
+    }
+    CHECK(i == x->count && j == y->count, "%s: rosters differ in length", what);
+    CHECK(!differ, "%s: %d students differ", what, differ);
+}
+
+static void append_journal(const char *line, int len) {
+    FILE *f = fopen(DATA_DIR "/" CORE_JOURNAL, "a");
+    CHECK(f && len > 0, "cannot journal");
+    if (f) { fwrite(line, 1, (size_t)len, f); fclose(f); }
+}
+
+/* ---------- Rows core_load cannot take ---------- */
+#define REJECTS_MAX 32
+static char rejects[REJECTS_MAX][96];
+static int nrejects;
+
+static void record_rejected(const char *file, int line, const char *row, const char *why) {
+    (void)row;
+    if (nrejects < REJECTS_MAX) snprintf(rejects[nrejects], sizeof(rejects[0]), "%s:%d %s", file, line, why);
+    nrejects++;
+}
+
+static void write_data(const char *name, const char *text) {
+    char path[256];
+    snprintf(path, sizeof(path), DATA_DIR "/%s", name);
+    FILE *f = fopen(path, "w");
+    CHECK(f != NULL, "cannot write %s", path);
+    if (f) { fputs(text, f); fclose(f); }
+}
+
+/* ---------- Tests ---------- */
+static void test_csv_round_trip(void) {
+    core_generate(&a, 300, 7);
+    core_delete_student(&a, 10);
+    core_save(&a, NULL);
+    rejected_rows = 0;
+    CHECK(core_load(&b, NULL, count_rejected) == 0, "core_load failed");
+    CHECK(rejected_rows == 0, "round trip: %d rows rejected", rejected_rows);
+    CHECK(b.count == a.count - 1, "round trip: %d students, then %d", a.count - 1, b.count);
+    check_same_roster(&a, &b, "round trip");
+}
+
+/* every change a journal line carries: a new student, marks, attendance
+   and a student record edit; replayed once, twice, and loaded twice */
+static void test_journal_replay(void) {
+    core_generate(&a, 100, 11);
+    core_save(&a, NULL);
+    char line[512];
+
+    Student s;
+    memset(&s, 0, sizeof(s));
+    s.id = 99000001;
+    snprintf(s.roll, sizeof(s.roll), "R99");
+    snprintf(s.name, sizeof(s.name), "Journal Student");
+    snprintf(s.email, sizeof(s.email), "j@example.com");
+    snprintf(s.phone, sizeof(s.phone), "9000000000");
+    snprintf(s.dept, sizeof(s.dept), "B.Tech CSE");
+    snprintf(s.password, sizeof(s.password), "pw");
+    s.age = 19;
+    s.year = 1;
+    s.current_semester = 2;
+    int slot = core_add_student(&a, &s);
+    CHECK(slot >= 0, "cannot add a student");
+    core_enroll_upto(&a, slot, 2);
+    append_journal(line, core_journal_student(&a, slot, line, sizeof(line)));
+
+    Enrollment *e = &a.enrollments[a.students[slot].first];
+    e->marks = 88;
+    e->held = 12;
+    e->attended = 9;
+    append_journal(line, core_journal_enrollment(&a, slot, e, line, sizeof(line)));
+
+    e = &a.enrollments[a.students[5].first + 1];
+    e->marks = 41;
+    e->held += 1;
+    append_journal(line, core_journal_enrollment(&a, 5, e, line, sizeof(line)));
+    snprintf(a.students[5].email, sizeof(a.students[5].email), "moved@example.com");
+    a.students[5].current_semester = a.students[5].current_semester < 8 ? a.students[5].current_semester + 1 : 8;
+    core_enroll_upto(&a, 5, a.students[5].current_semester);
+    append_journal(line, core_journal_student(&a, 5, line, sizeof(line)));
+    for (int i = 0; i < a.count; ++i) core_update_cgpa(&a, i);
+
+    rejected_rows = 0;
+    core_load(&b, NULL, count_rejected);
+    check_same_roster(&a, &b, "journal replayed once");
+    core_load(&c, NULL, count_rejected);
+    check_same_roster(&b, &c, "journal loaded again");
+
+    /* the whole journal a second time: post-images, so nothing changes */
+    FILE *f = fopen(DATA_DIR "/" CORE_JOURNAL, "r");
+    char all[4096];
+    size_t n = f ? fread(all, 1, sizeof(all), f) : 0;
+    if (f) fclose(f);
+    append_journal(all, (int)n);
+    core_load(&c, NULL, count_rejected);
+    check_same_roster(&a, &c, "journal replayed twice");
+    CHECK(rejected_rows == 0, "journal: %d rows rejected", rejected_rows);
+
+    /* a save folds the journal in and removes it */
+    core_save(&c, NULL);
+    CHECK(access(DATA_DIR "/" CORE_JOURNAL, F_OK) != 0, "journal left after core_save");
+    core_load(&b, NULL, count_rejected);
+    check_same_roster(&a, &b, "after checkpoint");
+}
+
+/* every kind of row core_load leaves out, each reported once with its
+   file and line, while the good rows around it still load */
+static void test_load_rejects(void) {
+    mkdir(DATA_DIR, 0755);
+    write_data("subjects.csv",
+               "S11,C101,Programming,4,1\n"
+               "S12,C102,Lab,2,1\n"
+               "S13,C103,Short\n"
+               "S14,C104,Maths,four,1\n");
+    write_data("students.csv",
+               "1001,R1,Asha,a@example.com,9000000001,1,1\n"
+               "abc,R2,Bad,b@example.com,9000000002,1,1\n"
+               "1002,R3,Ravi,r@example.com,9000000003,1,x\n"
+               "1001,R4,Again,d@example.com,9000000004,1,1\n"
+               "1003,R5,Short\n"
+               "\n"
+               "1004,R6,Meera,m@example.com,9000000006,1,1\n");
+    write_data("accounts.csv",
+               "1001,pw1,19,B.Tech CSE\n"
+               "1009,pw9,19,B.Tech CSE\n"
+               "1004,pw4,old,B.Tech CSE\n");
+    write_data("marks.csv",
+               "1001,S11,78\n"
+               "1001,S12,lots\n"
+               "1042,S11,50\n");
+    write_data("attendance.csv",
+               "1004,S12,3,4\n"
+               "1004,S12,3\n");
+    write_data(CORE_JOURNAL,
+               "X,1001\n"
+               "E,abc,S11,1,1,1\n"
+               "E,1004,S11,64,5,6\n");
+
+    static const char *const want[] = {
+        "subjects.csv:3 too few fields",
+        "subjects.csv:4 credits or semester is not a number",
+        "students.csv:2 id is not a positive number",
+        "students.csv:3 year or semester is not a number",
+        "students.csv:4 duplicate id",
+        "students.csv:5 too few fields",
+        "accounts.csv:2 no such student",
+        "accounts.csv:3 age is not a number",
+        "marks.csv:2 marks is not a number",
+        "marks.csv:3 no such student",
+        "attendance.csv:2 too few fields",
+        CORE_JOURNAL ":1 malformed record",
+        CORE_JOURNAL ":2 no valid id",
+    };
+    int nwant = (int)(sizeof(want) / sizeof(want[0]));
+    nrejects = 0;
+    CHECK(core_load(&a, NULL, record_rejected) == 0, "core_load failed");
+    CHECK(nrejects == nwant, "%d rows rejected, expected %d", nrejects, nwant);
+    for (int i = 0; i < nwant && i < nrejects; ++i)
+        CHECK(strcmp(rejects[i], want[i]) == 0, "reject %d: \"%s\", expected \"%s\"", i, rejects[i], want[i]);
+
+    CHECK(a.subject_count == 2, "%d subjects loaded, expected 2", a.subject_count);
+    CHECK(a.count == 2, "%d students loaded, expected 2", a.count);
+    static CoreIndex ix;
+    core_index_build(&ix, &a);
+    int asha = core_student_slot(&ix, &a, 1001), meera = core_student_slot(&ix, &a, 1004);
+    CHECK(asha >= 0 && strcmp(a.students[asha].name, "Asha") == 0, "the first 1001 was not kept");
+    CHECK(asha >= 0 && strcmp(a.students[asha].password, "pw1") == 0, "1001's account row was not applied");
+    const Enrollment *e = asha >= 0 ? core_enrollment(&a, asha, 0) : NULL;
+    CHECK(e && e->marks == 78, "1001's good marks row was not applied");
+    e = meera >= 0 ? core_enrollment(&a, meera, 1) : NULL;
+    CHECK(e && e->attended == 3 && e->held == 4, "1004's good attendance row was not applied");
+    e = meera >= 0 ? core_enrollment(&a, meera, 0) : NULL;
+    CHECK(e && e->marks == 64 && e->held == 6, "the good journal line was not replayed");
+
+    /* a reload with no callback leaves out the same rows, silently */
+    CHECK(core_load(&b, NULL, NULL) == 0, "core_load without a callback failed");
+    check_same_roster(&a, &b, "load without a callback");
+}
+
+static void test_generator(void) {
+    core_generate(&a, 500, 42);
+    core_generate(&b, 500, 42);
+    check_same_roster(&a, &b, "same seed");
+
+    /* a smaller count is a prefix */
+    core_generate(&c, 200, 42);
+    CHECK(c.count == 200, "generated %d of 200", c.count);
+    int differ = 0;
+    for (int i = 0; i < c.count; ++i) differ += !same_student(&a, i, &c, i);
+    CHECK(!differ, "prefix: %d of the first 200 students differ", differ);
+
+    core_generate(&c, 500, 43);
+    differ = 0;
+    for (int i = 0; i < c.count; ++i) differ += !same_student(&a, i, &c, i);
+    CHECK(differ > 400, "another seed: only %d of 500 students differ", differ);
+
+    /* the CSV path writes the same roster */
+    CHECK(core_generate_csv(500, 42) == 0, "core_generate_csv failed");
+    rejected_rows = 0;
+    core_load(&c, NULL, count_rejected);
+    CHECK(rejected_rows == 0, "generated CSV: %d rows rejected", rejected_rows);
+    check_same_roster(&a, &c, "CSV generator");
+}
+
+/* ---------- Web plumbing ---------- */
+/* feed req to a fresh parser step bytes at a time, as a socket would
+   deliver it, until it completes or fails; *fed gets the bytes offered */
+static int parse_in_steps(HttpParser *hp, const char *req, size_t len, size_t step, size_t *fed) {
+    http_parser_init(hp);
+    int rc = HP_NEED_MORE;
+    size_t have = 0;
+    while (rc == HP_NEED_MORE && have < len) {
+        have = have + step < len ? have + step : len;
+        rc = http_parse(hp, req, have);
+    }
+    if (fed) *fed = have;
+    return rc;
+}
+
+static int parse_status(const char *req) {
+    HttpParser hp;
+    int rc = parse_in_steps(&hp, req, strlen(req), strlen(req), NULL);
+    return rc == HP_ERROR ? hp.status : rc == HP_COMPLETE ? 200 : 0;
+}
+
+static void test_http_parser(void) {
+    static const char req[] =
+        "POST /enter-marks?id=1001&semester=3 HTTP/1.1\r\n"
+        "Host: results.example.edu\r\n"
+        "content-length:  5 \r\n"
+        "Cookie: theme=dark; sid=00ab0123456789abcdef0123456789abcdef\r\n"
+        "\r\n"
+        "hello";
+    size_t len = sizeof(req) - 1, head = len - 5;
+
+    /* whole, byte by byte and in uneven pieces: the same request, which
+       completes exactly at the blank line */
+    static const size_t steps[] = { 1, 7, 64, sizeof(req) };
+    for (size_t k = 0; k < sizeof(steps) / sizeof(steps[0]); ++k) {
+        HttpParser hp;
+        size_t fed;
+        int rc = parse_in_steps(&hp, req, len, steps[k], &fed);
+        CHECK(rc == HP_COMPLETE, "step %zu: parse gave %d", steps[k], rc);
+        if (rc != HP_COMPLETE) continue;
+        CHECK(steps[k] != 1 || fed == head, "step 1: completed after %zu bytes, not at the blank line (%zu)", fed, head);
+        CHECK(hp.head_len == head, "step %zu: head_len %zu, expected %zu", steps[k], hp.head_len, head);
+        CHECK(hp.content_length == 5, "step %zu: content_length %ld", steps[k], hp.content_length);
+        HttpRequest r;
+        http_request_from_parser(&r, &hp, req);
+        CHECK(slice_eq(r.method, "POST") && slice_eq(r.path, "/enter-marks") &&
+              slice_eq(r.query, "id=1001&semester=3") && slice_eq(r.version, "HTTP/1.1"),
+              "step %zu: request line split wrongly", steps[k]);
+        CHECK(r.nheaders == 3, "step %zu: %d headers", steps[k], r.nheaders);
+        CHECK(slice_eq(http_header(&r, "HOST"), "results.example.edu"), "step %zu: Host", steps[k]);
+        CHECK(slice_eq(http_header(&r, "Content-Length"), "5"), "step %zu: value not trimmed", steps[k]);
+        CHECK(http_header(&r, "Accept").p == NULL, "step %zu: missing header found", steps[k]);
+        char tok[SESSION_TOKEN_LEN + 1];
+        const char *sid = session_cookie(&r, tok);
+        CHECK(sid && strcmp(sid, "00ab0123456789abcdef0123456789abcdef") == 0, "step %zu: sid cookie", steps[k]);
+    }
+
+    /* bare LF line ends, no query */
+    HttpParser hp;
+    static const char lf[] = "GET /list HTTP/1.0\nHost: x\n\n";
+    CHECK(parse_in_steps(&hp, lf, sizeof(lf) - 1, 1, NULL) == HP_COMPLETE && hp.content_length == -1,
+          "LF-only request not parsed");
+    HttpRequest r;
+    http_request_from_parser(&r, &hp, lf);
+    CHECK(slice_eq(r.path, "/list") && r.query.n == 0, "LF-only request: path split wrongly");
+    CHECK(session_cookie(&r, (char[SESSION_TOKEN_LEN + 1]){0}) == NULL, "sid cookie found without a Cookie header");
+
+    /* malformed requests are answered 400 */
+    CHECK(parse_status("get / HTTP/1.1\r\n\r\n") == 400, "lowercase method accepted");
+    CHECK(parse_status("GET  / HTTP/1.1\r\n\r\n") == 400, "empty target accepted");
+    CHECK(parse_status("GET / HTTP/2.0\r\n\r\n") == 400, "HTTP/2.0 accepted");
+    CHECK(parse_status("GET / HTTP/1.1\r\n folded\r\n\r\n") == 400, "obs-fold accepted");
+    CHECK(parse_status("GET / HTTP/1.1\r\nBad Name: x\r\n\r\n") == 400, "space in a header name accepted");
+    CHECK(parse_status("POST / HTTP/1.1\r\nContent-Length: 5x\r\n\r\n") == 400, "non-numeric Content-Length accepted");
+    CHECK(parse_status("POST / HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 6\r\n\r\n") == 400,
+          "conflicting Content-Lengths accepted");
+    CHECK(parse_status("POST / HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 5\r\n\r\n") == 200,
+          "repeated equal Content-Lengths refused");
+
+    /* chunked bodies are not implemented */
+    CHECK(parse_status("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") == 501, "Transfer-Encoding not refused with 501");
+
+    /* the body cap */
+    char big[128];
+    snprintf(big, sizeof(big), "POST / HTTP/1.1\r\nContent-Length: %d\r\n\r\n", MAX_BODY);
+    CHECK(parse_status(big) == 200, "a body of MAX_BODY refused");
+    snprintf(big, sizeof(big), "POST / HTTP/1.1\r\nContent-Length: %d\r\n\r\n", MAX_BODY + 1);
+    CHECK(parse_status(big) == 413, "a body over MAX_BODY not refused with 413");
+
+    /* the header count and the head cap */
+    static char many[MAX_HEADERS * 16 + 64];
+    int n = snprintf(many, sizeof(many), "GET / HTTP/1.1\r\n");
+    for (int i = 0; i < MAX_HEADERS; ++i) n += snprintf(many + n, sizeof(many) - (size_t)n, "X-%d: %d\r\n", i, i);
+    snprintf(many + n, sizeof(many) - (size_t)n, "\r\n");
+    CHECK(parse_status(many) == 200, "%d headers refused", MAX_HEADERS);
+    snprintf(many + n, sizeof(many) - (size_t)n, "X-More: 1\r\n\r\n");
+    CHECK(parse_status(many) == 431, "more than %d headers not refused with 431", MAX_HEADERS);
+
+    /* a head of exactly HEAD_CAP bytes, then one a byte longer, fed the
+       way the server reads it: never more than HEAD_CAP bytes */
+    static char huge[HEAD_CAP + 2];
+    n = snprintf(huge, sizeof(huge), "GET / HTTP/1.1\r\nX-Long: ");
+    memset(huge + n, 'a', (size_t)(HEAD_CAP - 4 - n));
+    memcpy(huge + HEAD_CAP - 4, "\r\n\r\n", 5);
+    CHECK(parse_status(huge) == 200, "a head of HEAD_CAP bytes refused");
+    memcpy(huge + HEAD_CAP - 4, "a\r\n\r\n", 6);
+    size_t fed;
+    int rc = parse_in_steps(&hp, huge, HEAD_CAP, 100, &fed);
+    CHECK(rc == HP_ERROR && hp.status == 431 && fed == HEAD_CAP,
+          "a head over HEAD_CAP: status %d after %zu bytes, expected 431 after %d", hp.status, fed, HEAD_CAP);
+    CHECK(parse_status(huge) == 431, "a head over HEAD_CAP fed whole not refused with 431");
+}
+
+static void test_form_decoding(void) {
+    Arena arena = {0};
+    FormTable t;
+    const char *q = "name=J%C3%B6rg+M%2fx&subject=Linux+Lab&empty&=lost&odd=100%25%zz%4"
+                    "&subject=Problem%20Solving&subject=Linux+Lab&&last=";
+    form_parse(&t, &arena, q, strlen(q));
+
+    CHECK(t.nfields == 5, "%d fields, expected 5", t.nfields);
+    const char *v = form_get(&t, "name");
+    CHECK(v && strcmp(v, "J\xc3\xb6rg M/x") == 0, "percent-decoding: \"%s\"", v ? v : "(null)");
+    v = form_get(&t, "odd");
+    CHECK(v && strcmp(v, "100%%zz%4") == 0, "bad escapes not kept literally: \"%s\"", v ? v : "(null)");
+    v = form_get(&t, "empty");
+    CHECK(v && v[0] == 0, "a key without '=' has no empty value");
+    v = form_get(&t, "last");
+    CHECK(v && v[0] == 0, "a key with '=' and nothing after has no empty value");
+    CHECK(form_get(&t, "") == NULL, "an empty key was kept");
+    CHECK(form_get(&t, "missing") == NULL, "a missing key was found");
+
+    /* repeated keys keep every value, in order, and form_get gives the first */
+    const FormField *f = form_field(&t, "subject");
+    static const char *const subjects[] = { "Linux Lab", "Problem Solving", "Linux Lab" };
+    CHECK(f && f->count == 3, "subject: %d values, expected 3", f ? f->count : 0);
+    int i = 0;
+    for (const FormValue *fv = f ? f->first : NULL; fv; fv = fv->next, ++i)
+        CHECK(i < 3 && strcmp(fv->value, subjects[i]) == 0, "subject value %d: \"%s\"", i, fv->value);
+    CHECK(strcmp(form_get(&t, "subject"), "Linux Lab") == 0, "form_get is not the first value");
+
+    /* enough keys to grow the table several times, and one value each
+       of a size that bypasses the arena blocks */
+    arena_reset(&arena);
+    static char many[300 * 16 + ARENA_LARGE + 16];
+    int n = 0;
+    for (int k = 0; k < 300; ++k) n += snprintf(many + n, sizeof(many) - (size_t)n, "%sk%d=%d", k ? "&" : "", k, k * 7);
+    n += snprintf(many + n, sizeof(many) - (size_t)n, "&large=");
+    memset(many + n, 'x', ARENA_LARGE);
+    n += ARENA_LARGE;
+    form_parse(&t, &arena, many, (size_t)n);
+    int wrong = 0;
+    for (int k = 0; k < 300; ++k) {
+        char key[16];
+        snprintf(key, sizeof(key), "k%d", k);
+        v = form_get(&t, key);
+        wrong += !v || atoi(v) != k * 7;
+    }
+    CHECK(t.nfields == 301 && !wrong, "%d fields, %d of 300 values wrong", t.nfields, wrong);
+    v = form_get(&t, "large");
+    CHECK(v && strlen(v) == ARENA_LARGE, "large value lost");
+    arena_reset(&arena);
+    free(arena.head);
+}
+
+static void route_a(const RouteCtx *rc) { (void)rc; }
+static void route_b(const RouteCtx *rc) { (void)rc; }
+
+static const Route TEST_ROUTES[] = {
+    { M_GET,  "/",                route_a, 0 },
+    { M_GET,  "/attendance",      route_a, 0 },
+    { M_POST, "/attendance",      route_b, 0 },
+    { M_ANY,  "/attendance-mark", route_a, 0 },
+    { M_GET,  "/reports/*",       route_a, 0 },
+    { M_ANY,  "/api/v1",          route_a, 0 },
+    { M_ANY,  "/api/v1/*",        route_b, 0 },
+    { M_GET,  "/jobs/*",          route_a, 0 },
+    { M_POST, "/jobs/*",          route_b, 0 },
+};
+
+/* the route path and method fall to (NULL: 404 or 405), and its param */
+static const Route *match(const char *path, int method, const char **param) {
+    const Route *const *slots = route_match(path, param);
+    return slots ? slots[method] : NULL;
+}
+
+static void test_routes(void) {
+    CHECK(routes_init(TEST_ROUTES, sizeof(TEST_ROUTES) / sizeof(TEST_ROUTES[0])) == 0, "routes_init failed");
+    const Route *R = TEST_ROUTES;
+    const char *param;
+
+    /* exact matches, per method */
+    CHECK(match("/", M_GET, &param) == &R[0] && param[0] == 0, "/");
+    CHECK(match("/attendance", M_GET, &param) == &R[1], "GET /attendance");
+    CHECK(match("/attendance", M_POST, &param) == &R[2], "POST /attendance");
+    CHECK(match("/attendance-mark", M_GET, &param) == &R[3] && match("/attendance-mark", M_POST, &param) == &R[3] &&
+          match("/attendance-mark", M_OTHER, &param) == &R[3], "M_ANY route");
+
+    /* a route is not a prefix of its neighbours */
+    CHECK(route_match("/attendance-", &param) == NULL, "/attendance- matched");
+    CHECK(route_match("/attendanc", &param) == NULL, "/attendanc matched");
+    CHECK(route_match("/attendance/x", &param) == NULL, "/attendance/x matched");
+    CHECK(route_match("/nothing", &param) == NULL, "/nothing matched");
+
+    /* wildcards take the remainder; an exact route beats them */
+    CHECK(match("/reports/r1.html", M_GET, &param) == &R[4] && strcmp(param, "r1.html") == 0, "/reports/*");
+    CHECK(match("/reports/", M_GET, &param) == &R[4] && param[0] == 0, "/reports/ with nothing after");
+    CHECK(route_match("/reports", &param) == NULL, "/reports matched /reports/*");
+    CHECK(match("/api/v1", M_POST, &param) == &R[5], "/api/v1 exact");
+    CHECK(match("/api/v1/students/7", M_GET, &param) == &R[6] && strcmp(param, "students/7") == 0, "/api/v1/*");
+    CHECK(match("/jobs/12", M_GET, &param) == &R[7] && match("/jobs/12", M_POST, &param) == &R[8] &&
+          strcmp(param, "12") == 0, "/jobs/* per method");
+
+    /* a path with routes but none for the method: 405 */
+    const Route *const *slots = route_match("/attendance", &param);
+    CHECK(slots && slots[M_OTHER] == NULL, "/attendance has a route for other methods");
+    slots = route_match("/reports/x", &param);
+    CHECK(slots && slots[M_POST] == NULL, "/reports/* has a POST route");
+
+    /* more routes than trie nodes */
+    static char patterns[600][16];
+    static Route many[600];
+    for (int i = 0; i < 600; ++i) {
+        snprintf(patterns[i], sizeof(patterns[i]), "/r%03d", i);
+        many[i] = (Route){ M_GET, patterns[i], route_a, 0 };
+    }
+    CHECK(routes_init(many, 600) < 0, "a trie over its node limit was accepted");
+}
+
+static long long monotonic_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec;
+}
+
+static void test_sessions(void) {
+    static SessionTable st;
+    memset(&st, 0, sizeof(st));
+    char tok[SESSION_TOKEN_LEN + 1], other[SESSION_TOKEN_LEN + 1];
+    int sid = 0;
+
+    CHECK(session_create(&st, 1001, tok) == 0, "session_create failed");
+    CHECK(strlen(tok) == SESSION_TOKEN_LEN, "token of %zu characters", strlen(tok));
+    int slot = session_find(&st, tok, &sid);
+    CHECK(slot >= 0 && sid == 1001, "new session not found");
+    CHECK(session_create(&st, 1002, other) == 0 && strcmp(tok, other) != 0, "second session");
+    CHECK(session_find(&st, other, &sid) >= 0 && sid == 1002, "second session not found");
+
+    /* anything but the exact token is refused */
+    char bad[SESSION_TOKEN_LEN + 1];
+    memcpy(bad, tok, sizeof(bad));
+    bad[SESSION_TOKEN_LEN - 1] = bad[SESSION_TOKEN_LEN - 1] == '0' ? '1' : '0';
+    CHECK(session_find(&st, bad, &sid) < 0, "token with another key accepted");
+    memcpy(bad, tok, sizeof(bad));
+    bad[5] = 'G';
+    CHECK(session_find(&st, bad, &sid) < 0, "token with a non-hex character accepted");
+    memcpy(bad, "ffff", 4);
+    CHECK(session_find(&st, bad, &sid) < 0, "token naming a slot past the table accepted");
+    CHECK(session_find(&st, NULL, &sid) < 0 && session_find(&st, "", &sid) < 0, "empty token accepted");
+    bad[SESSION_TOKEN_LEN - 1] = 0;
+    CHECK(session_find(&st, bad, &sid) < 0, "short token accepted");
+
+    /* sign-out and expiry */
+    session_end(&st, other);
+    CHECK(session_find(&st, other, &sid) < 0, "session found after session_end");
+    long long now = monotonic_s();
+    atomic_store(&st.slot[slot].expires, now);
+    CHECK(session_find(&st, tok, &sid) < 0, "expired session found");
+
+    /* one in the second half of its lifetime slides */
+    CHECK(session_create(&st, 1003, tok) == 0, "session_create after expiry failed");
+    slot = session_find(&st, tok, &sid);
+    CHECK(slot >= 0, "new session not found");
+    if (slot < 0) return;
+    atomic_store(&st.slot[slot].expires, now + 10);
+    CHECK(session_find(&st, tok, &sid) >= 0 && atomic_load(&st.slot[slot].expires) >= now + SESSION_TTL_S,
+          "session not extended");
+
+    /* a full table replaces the session that expires first, no other */
+    static char toks[SESSION_MAX][SESSION_TOKEN_LEN + 1];
+    memset(&st, 0, sizeof(st));
+    int made = 0;
+    for (int i = 0; i < SESSION_MAX; ++i) made += session_create(&st, 1 + i, toks[i]) == 0;
+    CHECK(made == SESSION_MAX, "%d of %d sessions created", made, SESSION_MAX);
+    int oldest = session_find(&st, toks[SESSION_MAX / 2], &sid);
+    CHECK(oldest >= 0, "session %d not found", SESSION_MAX / 2);
+    if (oldest < 0) return;
+    atomic_store(&st.slot[oldest].expires, now + 60);
+    CHECK(session_create(&st, 5000, tok) == 0, "no session created in a full table");
+    CHECK(session_find(&st, tok, &sid) == oldest && sid == 5000, "the new session is not in the oldest's slot");
+    CHECK(session_find(&st, toks[SESSION_MAX / 2], &sid) < 0, "the replaced session is still found");
+    int lost = 0;
+    for (int i = 0; i < SESSION_MAX; ++i) if (i != SESSION_MAX / 2) lost += session_find(&st, toks[i], &sid) < 0;
+    CHECK(!lost, "%d other sessions lost", lost);
+}
+
+static int rm_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw) {
+    (void)st; (void)flag; (void)ftw;
+    return remove(path);
+}
+
+int main(void) {
+    char dir[] = "/tmp/student-test-XXXXXX", cwd[4096];
+    if (!mkdtemp(dir) || !getcwd(cwd, sizeof(cwd)) || chdir(dir) != 0) { perror("scratch dir"); return 1; }
+
+    static const struct { const char *name; void (*run)(void); } TESTS[] = {
+        { "csv_round_trip", test_csv_round_trip },
+        { "journal_replay", test_journal_replay },
+        { "load_rejects",   test_load_rejects },
+        { "generator",      test_generator },
+        { "http_parser",    test_http_parser },
+        { "form_decoding",  test_form_decoding },
+        { "routes",         test_routes },
+        { "sessions",       test_sessions },
+    };
+    for (size_t t = 0; t < sizeof(TESTS) / sizeof(TESTS[0]); ++t) {
+        int before = failures;
+        nftw(DATA_DIR, rm_entry, 8, FTW_DEPTH | FTW_PHYS);
+        TESTS[t].run();
+        printf("%-16s %s\n", TESTS[t].name, failures == before ? "ok" : "FAILED");
+    }
+
+    if (chdir(cwd) != 0) perror("chdir");
+    nftw(dir, rm_entry, 8, FTW_DEPTH | FTW_PHYS);
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures ? 1 : 0;
+}
@@ -8,7 +8,9 @@
 import os
 import html
 import subprocess
-from http.server import BaseHTTPRequestHandler, HTTPServer
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
 
 PORT = int(os.environ.get("PORT", "8080"))
 REPORTS_DIR = "reports"
@@ -21,6 +23,7 @@ DEMO_ARGS_CONSOLE = [BINARY_CONSOLE, "--demo"]
 DEMO_ARGS_WEB = [BINARY_WEB, "--demo"]
 TIMEOUT_SEC = 6
 OUTPUT_CHAR_LIMIT = 2000  # limit output shown on page
+REPORTS_RECHECK_SEC = 1.0  # how often the reports dir is stat'ed for changes
 
 def find_preferred_demo():
     """Return (binary_path, args_list) for demo run. Prefer student_system_web, else student_system."""
@@ -30,6 +33,28 @@ def find_preferred_demo():
         return (BINARY_CONSOLE, DEMO_ARGS_CONSOLE)
     return (None, None)
 
+# Demo output only changes when the binary does, so it is cached keyed on the
+# binary's path, mtime and size. The lock makes concurrent misses wait for one
+# run instead of each spawning the program.
+_demo_lock = threading.Lock()
+_demo_cache = {"key": None, "output": None}
+
+def cached_demo_output():
+    """Demo output for the current binary, running it only when it changed."""
+    binpath, _ = find_preferred_demo()
+    key = None
+    if binpath:
+        try:
+            st = os.stat(binpath)
+            key = (binpath, st.st_mtime_ns, st.st_size)
+        except OSError:
+            pass
+    with _demo_lock:
+        if _demo_cache["key"] != key or _demo_cache["output"] is None:
+            _demo_cache["output"] = safe_run_demo()
+            _demo_cache["key"] = key
+        return _demo_cache["output"]
+
 def safe_run_demo():
     """Run demo binary and return short text output (stdout or stderr)."""
     binpath, args = find_preferred_demo()
@@ -48,15 +73,46 @@ def safe_run_demo():
     except Exception as e:
         return f"Error running program: {html.escape(str(e))}"
 
+class ReportIndex:
+    """Sorted report listing for REPORTS_DIR (html and txt).
+
+    The directory's mtime changes whenever a file is added, removed or
+    renamed in it, so the listing is rescanned only then, and the directory
+    itself is stat'ed at most every REPORTS_RECHECK_SEC.
+    """
+
+    def __init__(self, path):
+        self.path = path
+        self.lock = threading.Lock()
+        self.files = []
+        self.dir_mtime = None
+        self.checked = 0.0
+
+    def _scan(self):
+        with os.scandir(self.path) as it:
+            return sorted(e.name for e in it
+                          if e.is_file() and e.name.lower().endswith((".html", ".htm", ".txt")))
+
+    def list(self):
+        now = time.monotonic()
+        with self.lock:
+            if now - self.checked < REPORTS_RECHECK_SEC:
+                return self.files
+            self.checked = now
+            try:
+                mtime = os.stat(self.path).st_mtime_ns
+                if mtime != self.dir_mtime:
+                    self.files = self._scan()
+                    self.dir_mtime = mtime
+            except OSError:
+                self.files, self.dir_mtime = [], None
+            return self.files
+
+reports_index = ReportIndex(REPORTS_DIR)
+
 def list_report_files():
     """Return list of report filenames in REPORTS_DIR (html and txt)."""
-    try:
-        if not os.path.isdir(REPORTS_DIR):
-            return []
-        files = sorted(f for f in os.listdir(REPORTS_DIR) if f.lower().endswith((".html", ".htm", ".txt")))
-        return files
-    except Exception:
-        return []
+    return reports_index.list()
 
 class Handler(BaseHTTPRequestHandler):
     def do_GET(self):
@@ -85,7 +141,7 @@ class Handler(BaseHTTPRequestHandler):
                 self.send_error(404, "Report not found")
             return
 
-        demo_output = safe_run_demo()
+        demo_output = cached_demo_output()
         reports = list_report_files()
         safe_demo = html.escape(demo_output)
 
@@ -144,7 +200,8 @@ def run():
         os.makedirs(REPORTS_DIR, exist_ok=True)
     except Exception as e:
         print("Warning: could not create reports dir:", e)
-    server = HTTPServer(("", PORT), Handler)
+    server = ThreadingHTTPServer(("", PORT), Handler)
+    server.daemon_threads = True
     print(f"Listening on port {PORT} (serving demo + reports).")
     try:
         server.serve_forever()